@@ -2,15 +2,23 @@
 #include <string.h>
 #include "pico/stdlib.h"
 #include "pico/time.h"
+#include "pico/stdio_usb.h"
 #include "hardware/clocks.h"
 #include "hardware/adc.h"
 #include "hardware/i2c.h"
 #include "hardware/uart.h"
 #include "hardware/pio.h"
 #include "hardware/pwm.h"
+#include "hardware/structs/systick.h"
 #include "pio_matrix.pio.h"
 #include "lib/ssd1306.h"
 #include "lib/font.h"
+#include "lib/flood_display.h"
+#include "lib/flood_pipeline.h"
+#include "lib/flood_forecast.h"
+#include "lib/flood_rollup.h"
+#include "lib/rtos_trace.h"
+#include "lib/boot_profile.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -30,8 +38,19 @@
 #define RED_LED 13 //Pino GPIO do Led Vermelho
 #define BUZZER 10// Pino GPIO do Buzzer 
 
+#define SAMPLE_PERIOD_MS 500 //Intervalo entre as leituras dos sensores
+#define MODE_CONSUMERS 2 //Número de tasks que consomem a fila de modo de operação
+#define PROTECTION_PRIORITY 2 //Prioridade das tasks de leitura, classificação e alerta
+#define DISPLAY_PRIORITY 1 //Prioridade da task do display (inicialização lenta via I2C)
+#define TRACE_DUMP_COMMAND 't' //Caractere recebido pela serial que solicita o envio do buffer de rastreamento
+#define TRACE_POLL_MS 100 //Intervalo de verificação de comandos na serial
+#ifndef TRACE_DUMP_PERIOD_MS
+#define TRACE_DUMP_PERIOD_MS 0 //Envio automático do buffer de rastreamento (ms); 0 envia apenas sob comando
+#endif
+
 QueueHandle_t xQueueJoystickData; //Definição da Fila para Valores do Joystick
 QueueHandle_t xQueueModeData; //Definição da Fila para Valores do Modo de Operação
+flood_rollup_t xRollup; //Agregados históricos (minuto/hora/dia), alimentados pela task de leitura
 
 //Definição de Struct para guardar os valores lido pelo Joystick
 typedef struct {
@@ -39,58 +58,129 @@ typedef struct {
     uint32_t y; //Valor lido do Eixo Y
     float river; //Valor normalizado para o nível do rio
     float rain; //Valor normalizado para intensidade de chuva
+    flood_status_t forecast; //Status mínimo indicado pela previsão de nível
+    uint32_t eta_danger_s; //Tempo previsto até o nível de perigo (s)
+    flood_status_t status; //Status efetivo, com a histerese da detecção de mudanças
+    bool alertMode; //Modo de alerta efetivo, com a histerese da detecção de mudanças
 }Joystick_data_t;
 
 //Definição de Struct para guardar o tipo de operação atual
 typedef struct 
 {
     bool alertMode; //Define o modo de operação
-    char *status; //Armazena o status Atual
+    const char *status; //Armazena o status Atual
 }OperationMode_data_t;
 
+//Definição de Struct para guardar os contadores e agregados informados a cada heartbeat
+typedef struct
+{
+    bool pending; //Indica que há um relatório ainda não enviado pela serial
+    uint32_t forwarded; //Amostras repassadas pela detecção de mudanças
+    uint32_t suppressed; //Amostras suprimidas pela detecção de mudanças
+    uint32_t forecast_cycles_max; //Maior custo medido de flood_forecast_update (ciclos)
+    flood_rollup_stats_t hour; //Agregado da última hora
+    flood_rollup_stats_t day; //Agregado das últimas 24 horas
+    flood_rollup_stats_t today; //Agregado do dia corrente
+}Telemetry_data_t;
+
+Telemetry_data_t xTelemetry; //Relatório do heartbeat, copiado pela leitura e enviado pela task do display
+
+/**
+ * @brief Ciclos do núcleo entre duas leituras do SysTick
+ *
+ * O SysTick (configurado pelo FreeRTOS com o clock do núcleo) conta para baixo e é
+ * recarregado a cada tick; o trecho medido deve ser menor que um tick
+ */
+uint32_t systick_cycles(uint32_t start, uint32_t end)
+{
+    return start >= end ? start - end : start + systick_hw->rvr + 1 - end;
+}
+
 /**
  * @brief Task usada para fazer a leitura dos sensores (eixo x e y do ADC)
  * 
  * Após a leitura, realiza a normalização para definir os valores de nível do rio
- * e volume de chuva 
+ * e volume de chuva. Somente as amostras que alteram algo (variação acima da banda
+ * morta ou cruzamento de limiar) são enviadas para a fila, além de um envio
+ * periódico mínimo (heartbeat)
  */
 void vReadJoystickValuesTask()
 {
+    boot_profile_mark(BOOT_SCHEDULER);
+
     adc_init();
     adc_gpio_init(JOYSTICK_X);
     adc_gpio_init(JOYSTICK_Y);
 
     Joystick_data_t joystick;
-    uint32_t adc_x_value, adc_y_value;
-    float river_level = 5.0, //Valor para definir o nível normal do Rio
-          intense_rain = 100.0;  //Intensidade Máxima de Chuva
+    flood_filter_t filter;
+    flood_change_detector_t detector;
+    flood_forecast_t forecast;
+    flood_filter_init(&filter);
+    flood_change_init(&detector);
+    flood_forecast_init(&forecast, SAMPLE_PERIOD_MS);
+    flood_change_t change;
+    int32_t river_mm, rain_x100;
+    uint32_t cycles, cycles_max = 0;
 
     while(true){
+        TRACE_SPAN_BEGIN(TRACE_SPAN_ADC_READ);
         //Faz a leitura do eixo X
         adc_select_input(0);
-        adc_x_value = adc_read();
+        joystick.x = adc_read();
 
         //Faz a leitura do eixo Y
         adc_select_input(1);
-        adc_y_value = adc_read();
-
-        if (adc_y_value > 2100){
-            //Indica que o nível do rio subiu; calcula o valor atual (pode aumentar até 10.0 metros)
-            joystick.river = river_level + (river_level * (adc_y_value - 2048) / 2047);
-        }else if (adc_y_value < 1800){
-            //Indica que o nível do rio desceu; calcula o valor atual (pode diminuir até 0 metros)
-            joystick.river = river_level - (river_level * (2048 - adc_y_value) / 2047);
-        }else {
-            joystick.river = river_level;
+        joystick.y = adc_read();
+        TRACE_SPAN_END(TRACE_SPAN_ADC_READ);
+        boot_profile_mark(BOOT_FIRST_SAMPLE);
+
+        //Normaliza e filtra os valores de nível do rio e intensidade de chuva
+        flood_normalize(joystick.x, joystick.y, &joystick.river, &joystick.rain);
+        flood_filter_apply(&filter, &joystick.river, &joystick.rain);
+
+        //Atualiza a previsão do nível do rio com os valores inteiros (sem conversões de float)
+        flood_normalize_fixed(joystick.x, joystick.y, &river_mm, &rain_x100);
+        TRACE_SPAN_BEGIN(TRACE_SPAN_FORECAST);
+        cycles = systick_hw->cvr;
+        flood_forecast_update(&forecast, river_mm, rain_x100);
+        cycles = systick_cycles(cycles, systick_hw->cvr);
+        TRACE_SPAN_END(TRACE_SPAN_FORECAST);
+        if (cycles > cycles_max) cycles_max = cycles;
+        joystick.forecast = flood_forecast_status(&forecast);
+        joystick.eta_danger_s = forecast.eta_s[FLOOD_FORECAST_DANGER];
+
+        //Acumula todas as amostras nos agregados históricos
+        taskENTER_CRITICAL();
+        flood_rollup_update(&xRollup, time_us_64() / 1000, river_mm, (uint32_t)rain_x100);
+        taskEXIT_CRITICAL();
+
+        //Envia os dados para a fila apenas se houver mudança relevante
+        change = flood_change_update(&detector, joystick.river, joystick.rain, river_mm, joystick.forecast);
+        if (change != FLOOD_CHANGE_NONE)
+        {
+            joystick.status = detector.status;
+            joystick.alertMode = detector.alert_mode;
+            xQueueSend(xQueueJoystickData, &joystick, 0);
+        }
+
+        //A cada heartbeat, apenas copia os contadores e os agregados. O envio pela serial
+        //pode bloquear (UART ou USB) e é feito pela task do display, de menor prioridade
+        if (change == FLOOD_CHANGE_HEARTBEAT)
+        {
+            taskENTER_CRITICAL();
+            xTelemetry.forwarded = detector.forwarded;
+            xTelemetry.suppressed = detector.suppressed;
+            xTelemetry.forecast_cycles_max = cycles_max;
+            flood_rollup_window(&xRollup, FLOOD_ROLLUP_MINUTE, &xTelemetry.hour);
+            flood_rollup_window(&xRollup, FLOOD_ROLLUP_HOUR, &xTelemetry.day);
+            flood_rollup_current(&xRollup, FLOOD_ROLLUP_DAY, &xTelemetry.today);
+            xTelemetry.pending = true;
+            taskEXIT_CRITICAL();
         }
-    
-        //Calcula a intensidade da chuva com base nos valores do eixo X
-        joystick.rain = (intense_rain * adc_x_value) / 4095.0;
 
-        //Envia os dados para a fila
-        xQueueSend(xQueueJoystickData, &joystick, 0);
         //Gera um delay de 0.5s
-        vTaskDelay(pdMS_TO_TICKS(500));
+        vTaskDelay(pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
     }
 }
 
@@ -103,48 +193,65 @@ void vMapStatus()
 {
     Joystick_data_t joystick;
     OperationMode_data_t mode;
-    float river_level = 5.0;
+
+    boot_profile_mark(BOOT_SCHEDULER);
 
     while (true){
         if(xQueueReceive(xQueueJoystickData, &joystick, portMAX_DELAY) == pdTRUE)
         {
-            mode.status = (char *)malloc(10 * sizeof(char));
-
-            if (joystick.river >= 9.0 || (joystick.river >= 7.0 && joystick.rain > 50.0))
-            {
-                strcpy(mode.status, "PERIGO");
-            }else if ((joystick.river >= 7.0 && joystick.rain > 50.0) || (joystick.river > river_level && joystick.rain > 50.0)){
-                strcpy(mode.status, "ALERTA");
-            }else if ((joystick.river > river_level && joystick.rain <= 50.0) || (joystick.river <= river_level && joystick.rain > 70.0)){
-                strcpy(mode.status, "ATENCAO");
-            }else {
-                strcpy(mode.status, "SEGURO");
-            }
+            //Status já escalado pela previsão e com histerese nas reduções (flood_change_update)
+            mode.status = flood_status_name(joystick.status);
 
             //Adiciona novamente os dados calculados na fila
             xQueueSend(xQueueJoystickData, &joystick, 0);
 
             //Verifica se o Modo de Alerta deve ser ativado
-            if (joystick.river >= 7.0 || joystick.rain > 80.0) {
-                mode.alertMode = true;
-            }else {
-                mode.alertMode = false;
-            }
+            mode.alertMode = joystick.alertMode;
+            boot_profile_mark(BOOT_FIRST_CLASSIFICATION);
             
-            //Salva na pilha 3 vezes para que possa ser acessado corretamente por cada task de periféricos
-            for (int i = 0; i < 3; i++) xQueueSend(xQueueModeData, &mode, 0);
+            //Salva na fila uma cópia para cada task de periféricos (display e alerta)
+            for (int i = 0; i < MODE_CONSUMERS; i++) xQueueSend(xQueueModeData, &mode, 0);
             
             vTaskDelay(pdMS_TO_TICKS(500)); //Espera 0.5s
         }//End: queueReceive
     }
 }
 
+/**
+ * @brief Envia pela serial o último relatório do heartbeat, se ainda não foi enviado
+ */
+void telemetry_report()
+{
+    Telemetry_data_t telemetry;
+
+    taskENTER_CRITICAL();
+    telemetry = xTelemetry;
+    xTelemetry.pending = false;
+    taskEXIT_CRITICAL();
+
+    if (!telemetry.pending) return;
+
+    printf("Amostras: %lu enviadas, %lu suprimidas\n",
+           (unsigned long)telemetry.forwarded, (unsigned long)telemetry.suppressed);
+    printf("Chuva 1h: %.2f\nChuva 24h: %.2f\nR max hoje: %.2f\n", telemetry.hour.rain_ms / (100.0f * 3600000.0f),
+           telemetry.day.rain_ms / (100.0f * 3600000.0f), telemetry.today.max_mm / 1000.0f);
+    printf("Previsao: max %lu ciclos (orcamento %u)\n", (unsigned long)telemetry.forecast_cycles_max,
+           FLOOD_FORECAST_CYCLE_BUDGET);
+}
+
 /**
  * @brief Task que exibe os resultados de leitura no display SSD1306
+ *
+ * Roda com prioridade menor que as tasks de proteção, então a inicialização da
+ * serial e do display não atrasa a primeira leitura, classificação e alerta. Pelo
+ * mesmo motivo, todos os envios pela serial (que podem bloquear) são feitos aqui
  */
 void vRealTimeInfo()
 {
     ssd1306_t ssd;
+    bool boot_reported = false, usb_connected = false;
+
+    stdio_init_all();
 
     /**
      * Primeiro, realiza as configurações de I2C e Display SSD1306
@@ -158,15 +265,11 @@ void vRealTimeInfo()
     //Configuração do display
     ssd1306_init(&ssd, WIDTH, HEIGHT, false, address, I2C_PORT); 
     ssd1306_config(&ssd); 
+    //O buffer é alocado zerado, então o primeiro envio já apaga todos os pixels
     ssd1306_send_data(&ssd); 
-    //Garante que o display inicialize com todos os pixels apagados    
-    ssd1306_fill(&ssd, false);
-    ssd1306_send_data(&ssd);
 
     OperationMode_data_t mode;
     Joystick_data_t joystick;
-    bool cor = true;
-    char *status;
 
     while (true)
     {
@@ -175,43 +278,43 @@ void vRealTimeInfo()
         {
             if (!mode.alertMode)
             {
-                char level_river[20], rain_in[20];
-                sprintf(level_river, "%.2f", joystick.river);
-                sprintf(rain_in, "%.2f", joystick.rain);
-
-                // Limpa o display (preenche com cor inversa)
-                ssd1306_fill(&ssd, !cor);                           
-                // Moldura externa
-                ssd1306_rect(&ssd, 3, 3, 122, 60, cor, !cor);        
-                // Linha abaixo do título "STATUS"
-                ssd1306_line(&ssd, 3, 14, 122, 14, cor);             
-                // Linha abaixo da palavra "PERIGO"
-                ssd1306_line(&ssd, 3, 30, 122, 30, cor);             
-                // Linha horizontal separando as duas linhas da "tabela"
-                ssd1306_line(&ssd, 3, 45, 122, 45, cor);             
-                // Linha vertical da tabela, separando letra e número
-                ssd1306_line(&ssd, 25, 30, 25, 60, cor);             
-                // Texto no topo (status)
-                ssd1306_draw_string(&ssd, "status", 45, 5);          
-                // Palavra que indica o status atual
-                ssd1306_draw_string(&ssd, mode.status, 35, 18);      
-                // Primeira linha da tabela: R e Valor do nível
-                ssd1306_draw_string(&ssd, "R", 10, 34);              
-                ssd1306_draw_string(&ssd, level_river, 30, 34);      
-                // Segunda linha da tabela: C e valor da intensidade de chuva
-                ssd1306_draw_string(&ssd, "C", 10, 49);              
-                ssd1306_draw_string(&ssd, rain_in, 30, 49);          
-                // Atualiza o display
-                ssd1306_send_data(&ssd);
+                //Tela com o status e os valores lidos (lib/flood_display.c)
+                flood_display_info(&flood_display_ssd1306, &ssd, mode.status, joystick.river, joystick.rain);
+                TRACE_SPAN_BEGIN(TRACE_SPAN_DISPLAY_SEND);
+                ssd1306_send_data(&ssd);                           // Atualiza o display
+                TRACE_SPAN_END(TRACE_SPAN_DISPLAY_SEND);
             }else {
-                ssd1306_fill(&ssd, !cor);                          // Limpa o display
-                ssd1306_rect(&ssd, 3, 3, 122, 60, cor, !cor);      // Desenha um retângulo
-                ssd1306_draw_string(&ssd, "RISCO ALTO", 10, 32);   // Desenha uma string
+                flood_display_alert(&flood_display_ssd1306, &ssd); // Tela de risco alto
+                TRACE_SPAN_BEGIN(TRACE_SPAN_DISPLAY_SEND);
                 ssd1306_send_data(&ssd);                           // Atualiza o display
+                TRACE_SPAN_END(TRACE_SPAN_DISPLAY_SEND);
+
+                //Consulta os agregados da última hora sem bloquear a task de leitura por muito tempo
+                flood_rollup_stats_t hour;
+                taskENTER_CRITICAL();
+                flood_rollup_window(&xRollup, FLOOD_ROLLUP_MINUTE, &hour);
+                taskEXIT_CRITICAL();
 
                 printf("R: %.2f\nC: %.2f\n", joystick.river, joystick.rain);
+                printf("R max 1h: %.2f\nChuva 1h: %.2f\n", hour.max_mm / 1000.0f, hour.rain_ms / (100.0f * 3600000.0f));
+                if (joystick.eta_danger_s != FLOOD_FORECAST_NEVER) printf("Perigo em: %lus\n", (unsigned long)joystick.eta_danger_s);
             }
 
+            //Relatório do heartbeat copiado pela task de leitura
+            telemetry_report();
+
+            //Informa os tempos de cada fase do boot assim que todas forem registradas (a UART
+            //recebe o relatório mesmo sem USB). Como a USB CDC costuma enumerar depois, o
+            //relatório é repetido quando um terminal USB se conecta (verificado sem bloquear)
+            boot_profile_mark(BOOT_FIRST_DISPLAY);
+            bool usb_now = stdio_usb_connected();
+            if (boot_profile_complete() && (!boot_reported || (usb_now && !usb_connected)))
+            {
+                boot_profile_report();
+                boot_reported = true;
+            }
+            usb_connected = usb_now;
+
             vTaskDelay(pdMS_TO_TICKS(500)); //Atualiza a cada 0.5s
         }//End: queueReceive
     }
@@ -234,6 +337,8 @@ uint32_t matrix_rgb(double r, double g, double b)
  */
 void vAlertModeTask()
 {
+    boot_profile_mark(BOOT_SCHEDULER);
+
     /**
      * Inicialização da PIO para utilizar a matriz de LEDS
      */
@@ -277,6 +382,7 @@ void vAlertModeTask()
             if (mode.alertMode)
             {
                 //Exibe o símbolo ! para indicar alerta visual
+                TRACE_SPAN_BEGIN(TRACE_SPAN_MATRIX_WRITE);
                 for (int i = 0; i < 25; i++)
                 {
                     if (frame[24-i] == 1) led_value = matrix_rgb(1.0,0.0,0.0);
@@ -284,6 +390,7 @@ void vAlertModeTask()
 
                     pio_sm_put_blocking(pio, sm, led_value);
                 }
+                TRACE_SPAN_END(TRACE_SPAN_MATRIX_WRITE);
 
                 //Liga o LED RGB Vermelho
                 gpio_put(RED_LED, true);
@@ -292,10 +399,12 @@ void vAlertModeTask()
                 pwm_set_enabled(slice_num, true);
             }else {
                 //Mantém a matriz de Leds apagada caso não esteja no modo de alerta
+                TRACE_SPAN_BEGIN(TRACE_SPAN_MATRIX_WRITE);
                 for (int i = 0; i < 25; i++) {
                     led_value = matrix_rgb(0.0,0.0,0.0);
                     pio_sm_put_blocking(pio, sm, led_value);
                 }
+                TRACE_SPAN_END(TRACE_SPAN_MATRIX_WRITE);
 
                 //Desliga o LED RGB Vermelho
                 gpio_put(RED_LED, false);
@@ -303,25 +412,76 @@ void vAlertModeTask()
                 pwm_set_enabled(slice_num, false);
                 gpio_put(BUZZER, false); //Garante que o buzzer está em nível baixo
             }
+            boot_profile_mark(BOOT_FIRST_ACTUATION);
 
             vTaskDelay(pdTICKS_TO_MS(500)); //Atualiza a cada 0.5s
         }//End: queueReceive
     }
 }
 
+/**
+ * @brief Task que envia o buffer de rastreamento pela serial quando solicitado
+ *
+ * O envio (~11 KB, cerca de 1 s de UART) só ocorre ao receber TRACE_DUMP_COMMAND, ou a
+ * cada TRACE_DUMP_PERIOD_MS se definido em tempo de compilação, para não ocupar a
+ * serial do operador. A gravação dos eventos continua sempre ativa
+ */
+void vTraceDumpTask()
+{
+#if TRACE_DUMP_PERIOD_MS > 0
+    TickType_t last_dump = xTaskGetTickCount();
+#endif
+    bool dump;
+
+    while (true)
+    {
+        vTaskDelay(pdMS_TO_TICKS(TRACE_POLL_MS));
+
+        //Verifica, sem bloquear, se o operador solicitou o envio pela serial
+        dump = getchar_timeout_us(0) == TRACE_DUMP_COMMAND;
+#if TRACE_DUMP_PERIOD_MS > 0
+        if (xTaskGetTickCount() - last_dump >= pdMS_TO_TICKS(TRACE_DUMP_PERIOD_MS)) dump = true;
+#endif
+        if (dump)
+        {
+            trace_dump();
+#if TRACE_DUMP_PERIOD_MS > 0
+            last_dump = xTaskGetTickCount();
+#endif
+        }
+    }
+}
+
 int main()
 {
-    stdio_init_all();
+    boot_profile_mark(BOOT_MAIN);
+
+    //Inicia os agregados históricos
+    flood_rollup_init(&xRollup, time_us_64() / 1000);
 
     //Cria a fila para armazenar os valores do Joystick
     xQueueJoystickData = xQueueCreate(5, sizeof(Joystick_data_t));
     //Cria a fila para armazenar qual o tipo de operação atual
     xQueueModeData = xQueueCreate(5, sizeof(OperationMode_data_t));
 
-    xTaskCreate(vReadJoystickValuesTask, "Read Joystick Task", configMINIMAL_STACK_SIZE, NULL, 1, NULL);
-    xTaskCreate(vMapStatus, "Define Status Task", configMINIMAL_STACK_SIZE, NULL, 1, NULL);
-    xTaskCreate(vRealTimeInfo, "Display Task", configMINIMAL_STACK_SIZE, NULL, 1, NULL);
-    xTaskCreate(vAlertModeTask, "AlertMode Task", configMINIMAL_STACK_SIZE, NULL, 1, NULL);
+    //As tasks de leitura e do display usam printf com %.2f e consultam os agregados, por isso têm pilha dobrada
+    TaskHandle_t xReadTask, xMapTask, xDisplayTask, xAlertTask;
+    xTaskCreate(vReadJoystickValuesTask, "Read Joystick Task", 2 * configMINIMAL_STACK_SIZE, NULL, PROTECTION_PRIORITY, &xReadTask);
+    xTaskCreate(vMapStatus, "Define Status Task", configMINIMAL_STACK_SIZE, NULL, PROTECTION_PRIORITY, &xMapTask);
+    xTaskCreate(vRealTimeInfo, "Display Task", 2 * configMINIMAL_STACK_SIZE, NULL, DISPLAY_PRIORITY, &xDisplayTask);
+    xTaskCreate(vAlertModeTask, "AlertMode Task", configMINIMAL_STACK_SIZE, NULL, PROTECTION_PRIORITY, &xAlertTask);
+
+#if TRACE_ENABLED
+    //Nomeia as tasks e filas para a linha do tempo do rastreamento
+    trace_name(xReadTask, "Read Joystick Task");
+    trace_name(xMapTask, "Define Status Task");
+    trace_name(xDisplayTask, "Display Task");
+    trace_name(xAlertTask, "AlertMode Task");
+    trace_name(xQueueJoystickData, "xQueueJoystickData");
+    trace_name(xQueueModeData, "xQueueModeData");
+    xTaskCreate(vTraceDumpTask, "Trace Dump Task", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
+#endif
+
     vTaskStartScheduler();
     panic_unsupported();
 }
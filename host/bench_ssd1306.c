@@ -0,0 +1,114 @@
+/**
+ * Microbenchmarks do framebuffer do SSD1306.
+ *
+ * Mede o custo (ns por operação) das primitivas de lib/ssd1306_gfx.c e do driver
+ * original (host/ssd1306_reference.c), inclusive a tela completa de vRealTimeInfo
+ * (lib/flood_display.c), e
+ * informa os bytes e transações I2C enviados por lib/ssd1306.c na configuração
+ * (ssd1306_config) e em cada atualização do display (ssd1306_send_data), contados pelo
+ * stub de hardware/i2c.h (host/stub).
+ *
+ * Uso:
+ *   bench_ssd1306 [--repeat N]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_reference.h"
+
+#define I2C_HZ 400000 //Frequência usada em vRealTimeInfo
+
+static ssd1306_t ssd;
+static i2c_inst_t bus;
+static unsigned repeat = 20000;
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//Impede que o compilador descarte o desenho
+static void consume(void)
+{
+  __asm__ volatile("" : : "r"(ssd.ram_buffer) : "memory");
+}
+
+static void op_fill(unsigned i) { ssd1306_fill(&ssd, i & 1); }
+static void op_fill_ref(unsigned i) { reference_fill(&ssd, i & 1); }
+static void op_line(unsigned i) { ssd1306_line(&ssd, 0, 0, 127, 63, i & 1); }
+static void op_line_ref(unsigned i) { reference_line(&ssd, 0, 0, 127, 63, i & 1); }
+static void op_rect(unsigned i) { ssd1306_rect(&ssd, 3, 3, 122, 60, i & 1, false); }
+static void op_rect_ref(unsigned i) { reference_rect(&ssd, 3, 3, 122, 60, i & 1, false); }
+static void op_rect_fill(unsigned i) { ssd1306_rect(&ssd, 3, 3, 122, 60, i & 1, true); }
+static void op_rect_fill_ref(unsigned i) { reference_rect(&ssd, 3, 3, 122, 60, i & 1, true); }
+static void op_glyph_aligned(unsigned i) { ssd1306_draw_char(&ssd, (char)('A' + i % 26), 40, 16); }
+static void op_glyph_aligned_ref(unsigned i) { reference_draw_char(&ssd, (char)('A' + i % 26), 40, 16); }
+static void op_glyph_unaligned(unsigned i) { ssd1306_draw_char(&ssd, (char)('A' + i % 26), 40, 18); }
+static void op_glyph_unaligned_ref(unsigned i) { reference_draw_char(&ssd, (char)('A' + i % 26), 40, 18); }
+static void op_screen(unsigned i) { flood_display_info(&flood_display_ssd1306, &ssd, "ATENCAO", 5.0f + (i % 500) / 100.0f, 42.17f); }
+static void op_screen_ref(unsigned i) { flood_display_info(&gfx_reference, &ssd, "ATENCAO", 5.0f + (i % 500) / 100.0f, 42.17f); }
+
+//Executa a operação "repeat" vezes e retorna o custo médio em ns
+static double measure(void (*op)(unsigned))
+{
+  double start = now_ns();
+  for (unsigned i = 0; i < repeat; i++)
+  {
+    op(i);
+    consume();
+  }
+  return (now_ns() - start) / repeat;
+}
+
+static void report(const char *name, void (*op)(unsigned), void (*ref)(unsigned))
+{
+  double ns = measure(op), ref_ns = measure(ref);
+  printf("  %-22s %10.1f ns/op  (original %10.1f ns/op, %6.1fx)\n", name, ns, ref_ns, ref_ns / ns);
+}
+
+//Tempo no barramento: cada byte ocupa 9 bits (com ACK), mais endereço, START e STOP por transação
+static double bus_us(size_t bytes, unsigned transactions)
+{
+  return (bytes * 9.0 + transactions * (9.0 + 2.0)) * 1e6 / I2C_HZ;
+}
+
+//Executa o envio com os contadores do stub zerados e informa o que foi escrito no barramento
+static void report_bus(const char *name, void (*send)(ssd1306_t *ssd))
+{
+  i2c_stub_reset(&bus);
+  send(&ssd);
+  printf("  %-26s %5zu bytes em %2u transacoes (~%.0f us)\n", name, bus.bytes, bus.transactions,
+         bus_us(bus.bytes, bus.transactions));
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2 && strcmp(argv[1], "--repeat") == 0) repeat = (unsigned)atoi(argv[2]);
+  if (repeat == 0) repeat = 1;
+
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, &bus);
+
+  printf("Primitivas (%u repeticoes):\n", repeat);
+  report("fill", op_fill, op_fill_ref);
+  report("line diagonal", op_line, op_line_ref);
+  report("rect 122x60", op_rect, op_rect_ref);
+  report("rect 122x60 cheio", op_rect_fill, op_rect_fill_ref);
+  report("glyph y=16 (alinhado)", op_glyph_aligned, op_glyph_aligned_ref);
+  report("glyph y=18", op_glyph_unaligned, op_glyph_unaligned_ref);
+  report("tela vRealTimeInfo", op_screen, op_screen_ref);
+
+  printf("Barramento I2C a %u kHz (lib/ssd1306.c, contado pelo stub):\n", I2C_HZ / 1000);
+  report_bus("ssd1306_config", ssd1306_config);
+  report_bus("ssd1306_config original", reference_config);
+  report_bus("ssd1306_send_data", ssd1306_send_data);
+  report_bus("ssd1306_send_data original", reference_send_data);
+
+  free(ssd.ram_buffer);
+  return 0;
+}
@@ -0,0 +1,440 @@
+/**
+ * Reprodução de traces de ADC no host.
+ *
+ * Passa as leituras brutas gravadas (CSV ou binário) pelas mesmas etapas da
+ * firmware (normalização, filtro, previsão, detecção de mudanças e classificação), na
+ * velocidade máxima do host. Informa amostras por segundo, custo de cada etapa
+ * (ns e ciclos por amostra), as transições de status e as mudanças da previsão com
+ * os tempos previstos até cada limiar, e compara esse registro com um arquivo golden.
+ *
+ * Uso:
+ *   flood_replay <trace.csv|trace.bin> [--golden arquivo] [--write-golden arquivo]
+ *                [--baseline arquivo] [--write-baseline arquivo] [--margin M] [--repeat N]
+ *
+ * Retorna 1 se as transições diferirem do golden ou se alguma etapa custar mais que
+ * M vezes (padrão 3) o baseline gravado, para que o CTest acuse a regressão.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdarg.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "flood_pipeline.h"
+#include "flood_forecast.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define cycles_now() __rdtsc()
+#else
+#define cycles_now() 0ULL //Sem contador de ciclos: apenas o tempo em ns é informado
+#endif
+
+#define SAMPLE_PERIOD_MS 500 //Mesmo intervalo de vReadJoystickValuesTask
+#define LOG_SIZE (1 << 20) //Tamanho máximo do registro de transições
+#define BASELINE_FLOOR_NS 2.0 //Menor baseline considerado por etapa (resolução da medição)
+
+//Trace carregado na memória
+typedef struct {
+    uint16_t *x; //Leituras do eixo X (chuva)
+    uint16_t *y; //Leituras do eixo Y (nível do rio)
+    size_t count;
+} trace_t;
+
+//Registro de transições, comparado com o golden
+typedef struct {
+    char text[LOG_SIZE];
+    size_t length;
+} replay_log_t;
+
+static volatile float sink; //Impede que o compilador descarte as etapas medidas
+
+static void __attribute__((format(printf, 2, 3))) replay_log(replay_log_t *log, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(log->text + log->length, LOG_SIZE - log->length, format, args);
+    va_end(args);
+    if (written > 0) log->length += (size_t)written;
+    if (log->length >= LOG_SIZE) log->length = LOG_SIZE - 1;
+}
+
+static bool trace_push(trace_t *trace, size_t *capacity, unsigned x, unsigned y)
+{
+    if (trace->count == *capacity)
+    {
+        *capacity = *capacity ? *capacity * 2 : 1024;
+        trace->x = realloc(trace->x, *capacity * sizeof(uint16_t));
+        trace->y = realloc(trace->y, *capacity * sizeof(uint16_t));
+        if (!trace->x || !trace->y) return false;
+    }
+    trace->x[trace->count] = (uint16_t)x;
+    trace->y[trace->count] = (uint16_t)y;
+    trace->count++;
+    return true;
+}
+
+/**
+ * @brief Carrega o trace: ".bin" são pares uint16 little-endian, o resto é CSV "adc_x,adc_y"
+ */
+static bool trace_load(const char *path, trace_t *trace)
+{
+    FILE *file = fopen(path, "rb");
+    size_t capacity = 0, length = strlen(path);
+    char line[128];
+    unsigned x, y;
+
+    memset(trace, 0, sizeof(*trace));
+    if (!file) return false;
+
+    if (length > 4 && strcmp(path + length - 4, ".bin") == 0)
+    {
+        uint8_t record[4];
+        while (fread(record, 1, sizeof(record), file) == sizeof(record))
+        {
+            if (!trace_push(trace, &capacity, record[0] | (record[1] << 8), record[2] | (record[3] << 8))) break;
+        }
+    }else {
+        while (fgets(line, sizeof(line), file))
+        {
+            if (line[0] == '#' || sscanf(line, "%u,%u", &x, &y) != 2) continue;
+            if (!trace_push(trace, &capacity, x, y)) break;
+        }
+    }
+
+    fclose(file);
+    return trace->count > 0;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Executa o pipeline amostra a amostra, como a firmware, registrando as transições
+ *
+ * O status e o modo de alerta só mudam nas amostras repassadas pela detecção de
+ * mudanças, como acontece em vMapStatus
+ */
+static void replay_functional(const trace_t *trace, replay_log_t *log)
+{
+    flood_filter_t filter;
+    flood_forecast_t forecast;
+    flood_change_detector_t detector;
+    flood_status_t status = FLOOD_SEGURO, last_forecast = FLOOD_SEGURO;
+    bool alert_mode = false;
+    uint32_t transitions = 0, forecast_changes = 0;
+    int32_t river_mm, rain_x100;
+    float river, rain;
+
+    flood_filter_init(&filter);
+    flood_forecast_init(&forecast, SAMPLE_PERIOD_MS);
+    flood_change_init(&detector);
+
+    for (size_t i = 0; i < trace->count; i++)
+    {
+        flood_normalize(trace->x[i], trace->y[i], &river, &rain);
+        flood_filter_apply(&filter, &river, &rain);
+        flood_normalize_fixed(trace->x[i], trace->y[i], &river_mm, &rain_x100);
+        flood_forecast_update(&forecast, river_mm, rain_x100);
+        flood_status_t predicted = flood_forecast_status(&forecast);
+
+        //Mudanças do status previsto, com os tempos até 5 m, 7 m e 9 m
+        if (predicted != last_forecast)
+        {
+            replay_log(log, "F %zu t=%lums %s -> %s eta=%" PRIu32 ",%" PRIu32 ",%" PRIu32 "s\n", i,
+                       (unsigned long)(i * SAMPLE_PERIOD_MS), flood_status_name(last_forecast),
+                       flood_status_name(predicted), forecast.eta_s[FLOOD_FORECAST_NORMAL],
+                       forecast.eta_s[FLOOD_FORECAST_HIGH], forecast.eta_s[FLOOD_FORECAST_DANGER]);
+            last_forecast = predicted;
+            forecast_changes++;
+        }
+
+        if (flood_change_update(&detector, river, rain, river_mm, predicted) == FLOOD_CHANGE_NONE) continue;
+
+        //Status e modo de alerta repassados a vMapStatus (escalados pela previsão, com histerese)
+        flood_status_t new_status = detector.status;
+        bool new_alert = detector.alert_mode;
+        if (i == 0 || new_status != status || new_alert != alert_mode)
+        {
+            replay_log(log, "T %zu t=%lums %s -> %s alert=%d R=%.2f C=%.2f\n", i,
+                       (unsigned long)(i * SAMPLE_PERIOD_MS), flood_status_name(status),
+                       flood_status_name(new_status), new_alert, river, rain);
+            status = new_status;
+            alert_mode = new_alert;
+            transitions++;
+        }
+    }
+
+    replay_log(log, "S samples=%zu forwarded=%lu suppressed=%lu transitions=%lu forecast_changes=%lu\n",
+               trace->count, (unsigned long)detector.forwarded, (unsigned long)detector.suppressed,
+               (unsigned long)transitions, (unsigned long)forecast_changes);
+}
+
+//Etapas medidas pelo benchmark, na ordem das linhas do arquivo de baseline
+typedef enum {
+    STAGE_NORMALIZE = 0,
+    STAGE_NORMALIZE_FIXED,
+    STAGE_FILTER,
+    STAGE_FORECAST,
+    STAGE_CHANGE,
+    STAGE_CLASSIFY,
+    STAGE_PIPELINE,
+    STAGES
+} stage_t;
+
+static const char *const stage_names[STAGES] = {
+    "normalizacao", "normalizacao_i", "filtro", "previsao", "mudancas", "classificacao", "pipeline"
+};
+
+static void stage_keep_min(double *best, double value)
+{
+    if (*best == 0 || value < *best) *best = value;
+}
+
+/**
+ * @brief Mede o custo de cada etapa isoladamente e do pipeline completo
+ *
+ * Cada etapa guarda o menor custo entre as repetições, que é o valor menos afetado
+ * por interrupções e outras tarefas do host
+ *
+ * @param ns Custo de cada etapa em ns por amostra (classificação: por amostra repassada)
+ */
+static void replay_benchmark(const trace_t *trace, unsigned repeat, double ns[STAGES])
+{
+    size_t n = trace->count;
+    float *river = malloc(n * sizeof(float)), *rain = malloc(n * sizeof(float));
+    int32_t *river_mm = malloc(n * sizeof(int32_t)), *rain_x100 = malloc(n * sizeof(int32_t));
+    bool *forward = malloc(n * sizeof(bool));
+    flood_status_t *predicted = malloc(n * sizeof(flood_status_t));
+    double start;
+    uint64_t cycles, c_forecast = 0, c_total = 0;
+    flood_filter_t filter;
+    flood_forecast_t forecast;
+    flood_change_detector_t detector;
+    size_t forwarded = 0;
+
+    for (int s = 0; s < STAGES; s++) ns[s] = 0;
+
+    for (unsigned r = 0; r < repeat; r++)
+    {
+        start = now_ns();
+        for (size_t i = 0; i < n; i++) flood_normalize(trace->x[i], trace->y[i], &river[i], &rain[i]);
+        stage_keep_min(&ns[STAGE_NORMALIZE], (now_ns() - start) / n);
+
+        start = now_ns();
+        for (size_t i = 0; i < n; i++) flood_normalize_fixed(trace->x[i], trace->y[i], &river_mm[i], &rain_x100[i]);
+        stage_keep_min(&ns[STAGE_NORMALIZE_FIXED], (now_ns() - start) / n);
+
+        flood_filter_init(&filter);
+        start = now_ns();
+        for (size_t i = 0; i < n; i++) flood_filter_apply(&filter, &river[i], &rain[i]);
+        stage_keep_min(&ns[STAGE_FILTER], (now_ns() - start) / n);
+
+        flood_forecast_init(&forecast, SAMPLE_PERIOD_MS);
+        start = now_ns();
+        cycles = cycles_now();
+        for (size_t i = 0; i < n; i++)
+        {
+            flood_forecast_update(&forecast, river_mm[i], rain_x100[i]);
+            predicted[i] = flood_forecast_status(&forecast);
+        }
+        cycles = cycles_now() - cycles;
+        if (c_forecast == 0 || cycles < c_forecast) c_forecast = cycles;
+        stage_keep_min(&ns[STAGE_FORECAST], (now_ns() - start) / n);
+
+        flood_change_init(&detector);
+        start = now_ns();
+        for (size_t i = 0; i < n; i++) forward[i] = flood_change_update(&detector, river[i], rain[i], river_mm[i], predicted[i]) != FLOOD_CHANGE_NONE;
+        stage_keep_min(&ns[STAGE_CHANGE], (now_ns() - start) / n);
+
+        forwarded = 0;
+        start = now_ns();
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!forward[i]) continue;
+            sink = (float)flood_classify(river[i], rain[i]) + flood_alert_mode(river[i], rain[i]);
+            forwarded++;
+        }
+        if (forwarded) stage_keep_min(&ns[STAGE_CLASSIFY], (now_ns() - start) / forwarded);
+
+        //Pipeline completo, amostra a amostra
+        flood_filter_init(&filter);
+        flood_forecast_init(&forecast, SAMPLE_PERIOD_MS);
+        flood_change_init(&detector);
+        start = now_ns();
+        cycles = cycles_now();
+        for (size_t i = 0; i < n; i++)
+        {
+            float rv, rn;
+            int32_t mm, rx;
+            flood_normalize(trace->x[i], trace->y[i], &rv, &rn);
+            flood_filter_apply(&filter, &rv, &rn);
+            flood_normalize_fixed(trace->x[i], trace->y[i], &mm, &rx);
+            flood_forecast_update(&forecast, mm, rx);
+            flood_status_t p = flood_forecast_status(&forecast);
+            if (flood_change_update(&detector, rv, rn, mm, p) != FLOOD_CHANGE_NONE)
+                sink = (float)flood_classify(rv, rn) + flood_alert_mode(rv, rn);
+        }
+        cycles = cycles_now() - cycles;
+        if (c_total == 0 || cycles < c_total) c_total = cycles;
+        stage_keep_min(&ns[STAGE_PIPELINE], (now_ns() - start) / n);
+    }
+
+    printf("Amostras: %zu x %u repeticoes (menor custo entre as repeticoes)\n", n, repeat);
+    printf("  normalizacao   %8.2f ns/amostra\n", ns[STAGE_NORMALIZE]);
+    printf("  normalizacao_i %8.2f ns/amostra (inteira, usada pela previsao)\n", ns[STAGE_NORMALIZE_FIXED]);
+    printf("  filtro         %8.2f ns/amostra\n", ns[STAGE_FILTER]);
+    printf("  previsao       %8.2f ns/amostra (%.1f ciclos/amostra no host)\n", ns[STAGE_FORECAST], (double)c_forecast / n);
+    printf("  mudancas       %8.2f ns/amostra\n", ns[STAGE_CHANGE]);
+    printf("  classificacao  %8.2f ns/amostra repassada (%zu repassadas)\n", ns[STAGE_CLASSIFY], forwarded);
+    printf("  pipeline       %8.2f ns/amostra (%.1f ciclos/amostra no host, %.0f amostras/s)\n",
+           ns[STAGE_PIPELINE], (double)c_total / n, 1e9 / ns[STAGE_PIPELINE]);
+
+    free(river);
+    free(rain);
+    free(river_mm);
+    free(rain_x100);
+    free(forward);
+    free(predicted);
+}
+
+/**
+ * @brief Compara o custo de cada etapa com o baseline gravado
+ *
+ * Uma etapa falha quando custa mais que "margin" vezes o baseline. Baselines abaixo de
+ * BASELINE_FLOOR_NS são arredondados para cima, pois nessa escala a medição é dominada
+ * pela resolução do relógio
+ */
+static bool baseline_check(const double ns[STAGES], const char *path, double margin)
+{
+    FILE *file = fopen(path, "r");
+    char name[32];
+    double value, budget;
+    bool ok = true, found[STAGES] = {false};
+
+    if (!file)
+    {
+        fprintf(stderr, "baseline nao encontrado: %s\n", path);
+        return false;
+    }
+    while (fscanf(file, "%31s %lf", name, &value) == 2)
+    {
+        for (int s = 0; s < STAGES; s++)
+        {
+            if (strcmp(name, stage_names[s]) != 0) continue;
+            found[s] = true;
+            budget = margin * (value > BASELINE_FLOOR_NS ? value : BASELINE_FLOOR_NS);
+            if (ns[s] > budget)
+            {
+                fprintf(stderr, "%s custou %.2f ns (baseline %.2f, limite %.2f)\n", name, ns[s], value, budget);
+                ok = false;
+            }
+        }
+    }
+    fclose(file);
+
+    for (int s = 0; s < STAGES; s++)
+    {
+        if (found[s]) continue;
+        fprintf(stderr, "etapa %s ausente do baseline %s\n", stage_names[s], path);
+        ok = false;
+    }
+    return ok;
+}
+
+static bool baseline_write(const double ns[STAGES], const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (!file) return false;
+    for (int s = 0; s < STAGES; s++) fprintf(file, "%s %.2f\n", stage_names[s], ns[s]);
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Compara o registro com o golden e mostra a primeira linha diferente
+ */
+static bool golden_check(const replay_log_t *log, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    static char expected[LOG_SIZE];
+    size_t length, line = 1;
+
+    if (!file)
+    {
+        fprintf(stderr, "golden nao encontrado: %s\n", path);
+        return false;
+    }
+    length = fread(expected, 1, LOG_SIZE - 1, file);
+    fclose(file);
+    expected[length] = '\0';
+
+    if (length == log->length && memcmp(expected, log->text, length) == 0) return true;
+
+    for (size_t i = 0; i < length && i < log->length; i++)
+    {
+        if (expected[i] != log->text[i]) break;
+        if (expected[i] == '\n') line++;
+    }
+    fprintf(stderr, "transicoes diferem do golden %s (linha %zu)\n", path, line);
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    const char *golden = NULL, *write_golden = NULL, *baseline = NULL, *write_baseline = NULL;
+    unsigned repeat = 20;
+    double margin = 3.0, ns[STAGES];
+    static replay_log_t log;
+    trace_t trace;
+    int result = 0;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "uso: %s <trace.csv|trace.bin> [--golden arquivo] [--write-golden arquivo]"
+                        " [--baseline arquivo] [--write-baseline arquivo] [--margin M] [--repeat N]\n", argv[0]);
+        return 2;
+    }
+
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--golden") == 0) golden = argv[i + 1];
+        else if (strcmp(argv[i], "--write-golden") == 0) write_golden = argv[i + 1];
+        else if (strcmp(argv[i], "--baseline") == 0) baseline = argv[i + 1];
+        else if (strcmp(argv[i], "--write-baseline") == 0) write_baseline = argv[i + 1];
+        else if (strcmp(argv[i], "--margin") == 0) margin = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--repeat") == 0) repeat = (unsigned)atoi(argv[i + 1]);
+    }
+    if (repeat == 0) repeat = 1;
+
+    if (!trace_load(argv[1], &trace))
+    {
+        fprintf(stderr, "nao foi possivel ler o trace %s\n", argv[1]);
+        return 2;
+    }
+
+    replay_functional(&trace, &log);
+    fputs(log.text, stdout);
+
+    replay_benchmark(&trace, repeat, ns);
+
+    if (write_golden)
+    {
+        FILE *file = fopen(write_golden, "wb");
+        if (!file || fwrite(log.text, 1, log.length, file) != log.length) result = 2;
+        if (file) fclose(file);
+    }
+    if (write_baseline && !baseline_write(ns, write_baseline)) result = 2;
+
+    if (golden && !golden_check(&log, golden)) result = 1;
+    if (baseline && !baseline_check(ns, baseline, margin)) result = 1;
+
+    free(trace.x);
+    free(trace.y);
+    return result;
+}
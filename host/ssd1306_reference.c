@@ -0,0 +1,151 @@
+#include "hardware/i2c.h"
+#include "ssd1306_reference.h"
+#include "font.h"
+
+void reference_config(ssd1306_t *ssd) {
+  ssd1306_command(ssd, SET_DISP | 0x00);
+  ssd1306_command(ssd, SET_MEM_ADDR);
+  ssd1306_command(ssd, 0x01);
+  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
+  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
+  ssd1306_command(ssd, SET_MUX_RATIO);
+  ssd1306_command(ssd, HEIGHT - 1);
+  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
+  ssd1306_command(ssd, SET_DISP_OFFSET);
+  ssd1306_command(ssd, 0x00);
+  ssd1306_command(ssd, SET_COM_PIN_CFG);
+  ssd1306_command(ssd, 0x12);
+  ssd1306_command(ssd, SET_DISP_CLK_DIV);
+  ssd1306_command(ssd, 0x80);
+  ssd1306_command(ssd, SET_PRECHARGE);
+  ssd1306_command(ssd, 0xF1);
+  ssd1306_command(ssd, SET_VCOM_DESEL);
+  ssd1306_command(ssd, 0x30);
+  ssd1306_command(ssd, SET_CONTRAST);
+  ssd1306_command(ssd, 0xFF);
+  ssd1306_command(ssd, SET_ENTIRE_ON);
+  ssd1306_command(ssd, SET_NORM_INV);
+  ssd1306_command(ssd, SET_CHARGE_PUMP);
+  ssd1306_command(ssd, 0x14);
+  ssd1306_command(ssd, SET_DISP | 0x01);
+}
+
+void reference_send_data(ssd1306_t *ssd) {
+  ssd1306_command(ssd, SET_COL_ADDR);
+  ssd1306_command(ssd, 0);
+  ssd1306_command(ssd, ssd->width - 1);
+  ssd1306_command(ssd, SET_PAGE_ADDR);
+  ssd1306_command(ssd, 0);
+  ssd1306_command(ssd, ssd->pages - 1);
+  i2c_write_blocking(
+    ssd->i2c_port,
+    ssd->address,
+    ssd->ram_buffer,
+    ssd->bufsize,
+    false
+  );
+}
+
+void reference_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  uint16_t index = (y >> 3) + (x << 3) + 1;
+  uint8_t pixel = (y & 0b111);
+  if (value)
+    ssd->ram_buffer[index] |= (1 << pixel);
+  else
+    ssd->ram_buffer[index] &= ~(1 << pixel);
+}
+
+void reference_fill(ssd1306_t *ssd, bool value) {
+    // Itera por todas as posições do display
+    for (uint8_t y = 0; y < ssd->height; ++y) {
+        for (uint8_t x = 0; x < ssd->width; ++x) {
+            reference_pixel(ssd, x, y, value);
+        }
+    }
+}
+
+void reference_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  for (uint8_t x = left; x < left + width; ++x) {
+    reference_pixel(ssd, x, top, value);
+    reference_pixel(ssd, x, top + height - 1, value);
+  }
+  for (uint8_t y = top; y < top + height; ++y) {
+    reference_pixel(ssd, left, y, value);
+    reference_pixel(ssd, left + width - 1, y, value);
+  }
+
+  if (fill) {
+    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
+      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
+        reference_pixel(ssd, x, y, value);
+      }
+    }
+  }
+}
+
+void reference_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+
+    int err = dx - dy;
+
+    while (true) {
+        reference_pixel(ssd, x0, y0, value); // Desenha o pixel atual
+
+        if (x0 == x1 && y0 == y1) break; // Termina quando alcança o ponto final
+
+        int e2 = err * 2;
+
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void reference_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  uint16_t index = 0;
+
+  if (c >= ' ' && c <= '~')
+  {
+    index = (c - ' ') * 8;
+  }
+
+  for (uint8_t i = 0; i < 8; ++i)
+  {
+    uint8_t line = font[index + i];
+    for (uint8_t j = 0; j < 8; ++j)
+    {
+      reference_pixel(ssd, x + i, y + j, line & (1 << j));
+    }
+  }
+}
+
+void reference_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+  while (*str)
+  {
+    reference_draw_char(ssd, *str++, x, y);
+    x += 8;
+    if (x + 8 >= ssd->width)
+    {
+      x = 0;
+      y += 8;
+    }
+    if (y + 8 >= ssd->height)
+    {
+      break;
+    }
+  }
+}
+
+const flood_display_gfx_t gfx_reference = {reference_fill, reference_rect, reference_line, reference_draw_string};
@@ -0,0 +1,26 @@
+#ifndef SSD1306_REFERENCE_H
+#define SSD1306_REFERENCE_H
+
+#include "ssd1306.h"
+#include "flood_display.h"
+
+/**
+ * Primitivas de desenho originais do driver SSD1306 (antes da separação entre
+ * framebuffer e transporte), copiadas como referência para os testes e benchmarks.
+ * Só são válidas para coordenadas dentro do display.
+ */
+void reference_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
+void reference_fill(ssd1306_t *ssd, bool value);
+void reference_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
+void reference_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
+void reference_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
+void reference_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+//Transporte original: cada comando em uma transação I2C separada (via ssd1306_command)
+void reference_config(ssd1306_t *ssd);
+void reference_send_data(ssd1306_t *ssd);
+
+//Primitivas originais para desenhar as telas de lib/flood_display.c com o driver original
+extern const flood_display_gfx_t gfx_reference;
+
+#endif
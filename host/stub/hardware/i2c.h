@@ -0,0 +1,34 @@
+#ifndef HARDWARE_I2C_H
+#define HARDWARE_I2C_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Substituto do hardware/i2c.h do Pico SDK para compilar lib/ssd1306.c no host.
+ *
+ * Nenhum dado é enviado: i2c_write_blocking apenas conta os bytes e as transações
+ * (cada chamada é uma transação: START, endereço, dados e STOP), guarda o tamanho e o
+ * primeiro byte (byte de controle do SSD1306) de cada uma e, nas transações de comando
+ * (controle 0x00 ou 0x80), a sequência de comandos recebida pelo display.
+ */
+
+#define I2C_STUB_LOG 32 //Número de transações registradas individualmente
+#define I2C_STUB_COMMANDS 64 //Número de bytes de comando registrados
+
+typedef struct i2c_inst {
+    size_t bytes; //Total de bytes de dados enviados
+    unsigned transactions; //Total de transações
+    size_t length[I2C_STUB_LOG]; //Tamanho de cada transação
+    uint8_t control[I2C_STUB_LOG]; //Primeiro byte de cada transação
+    uint8_t commands[I2C_STUB_COMMANDS]; //Comandos enviados, sem os bytes de controle
+    size_t command_count; //Número de comandos enviados
+} i2c_inst_t;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+//Zera os contadores antes de uma nova medição
+void i2c_stub_reset(i2c_inst_t *i2c);
+
+#endif
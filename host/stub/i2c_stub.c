@@ -0,0 +1,33 @@
+#include <string.h>
+#include "hardware/i2c.h"
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)addr;
+    (void)nostop;
+
+    if (i2c->transactions < I2C_STUB_LOG)
+    {
+        i2c->length[i2c->transactions] = len;
+        i2c->control[i2c->transactions] = len ? src[0] : 0;
+    }
+
+    //Byte de controle 0x00: todos os bytes seguintes são comandos; 0x80: apenas o próximo
+    if (len > 1 && (src[0] == 0x00 || src[0] == 0x80))
+    {
+        for (size_t i = 1; i < len && (src[0] == 0x00 || i == 1); i++)
+        {
+            if (i2c->command_count < I2C_STUB_COMMANDS) i2c->commands[i2c->command_count] = src[i];
+            i2c->command_count++;
+        }
+    }
+
+    i2c->transactions++;
+    i2c->bytes += len;
+    return (int)len;
+}
+
+void i2c_stub_reset(i2c_inst_t *i2c)
+{
+    memset(i2c, 0, sizeof(*i2c));
+}
@@ -0,0 +1,63 @@
+/**
+ * Regressão da normalização e da classificação.
+ *
+ * Compara lib/flood_pipeline.c com as regras originais de vReadJoystickValuesTask e
+ * vMapStatus (copiadas abaixo como referência) em toda a faixa do ADC.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "flood_pipeline.h"
+
+//Normalização original de vReadJoystickValuesTask
+static float reference_river(uint32_t adc_y_value)
+{
+    float river_level = 5.0;
+
+    if (adc_y_value > 2100){
+        return river_level + (river_level * (adc_y_value - 2048) / 2047);
+    }else if (adc_y_value < 1800){
+        return river_level - (river_level * (2048 - adc_y_value) / 2047);
+    }
+    return river_level;
+}
+
+//Classificação original de vMapStatus
+static const char *reference_status(float river, float rain)
+{
+    float river_level = 5.0;
+
+    if (river >= 9.0 || (river >= 7.0 && rain > 50.0))
+    {
+        return "PERIGO";
+    }else if ((river >= 7.0 && rain > 50.0) || (river > river_level && rain > 50.0)){
+        return "ALERTA";
+    }else if ((river > river_level && rain <= 50.0) || (river <= river_level && rain > 70.0)){
+        return "ATENCAO";
+    }
+    return "SEGURO";
+}
+
+int main(void)
+{
+    unsigned failures = 0;
+    float river, rain;
+
+    for (uint32_t x = 0; x <= FLOOD_ADC_MAX; x++)
+    {
+        for (uint32_t y = 0; y <= FLOOD_ADC_MAX; y++)
+        {
+            flood_normalize(x, y, &river, &rain);
+
+            bool alert = river >= 7.0 || rain > 80.0;
+            if (river != reference_river(y)
+                || strcmp(flood_status_name(flood_classify(river, rain)), reference_status(river, rain)) != 0
+                || flood_alert_mode(river, rain) != alert)
+            {
+                if (failures++ < 10) printf("diferenca em adc_x=%lu adc_y=%lu\n", (unsigned long)x, (unsigned long)y);
+            }
+        }
+    }
+
+    printf("%u diferencas\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * Regressão dos agregados históricos.
+ *
+ * Alimenta lib/flood_rollup.c com uma sequência de amostras com intervalos variados
+ * (inclusive pausas maiores que cada janela) e compara, após cada amostra, as consultas
+ * de todas as resoluções com um recálculo por força bruta sobre o histórico completo.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "flood_rollup.h"
+
+#define SAMPLES 6000
+#define START_MS 123456ULL //Instante de flood_rollup_init; os buckets se alinham a ele
+
+//Amostra guardada para o recálculo
+typedef struct {
+    uint64_t ms;
+    int32_t level_mm;
+    uint64_t rain_ms; //Parcela da chuva integrada nesta amostra
+} sample_t;
+
+static const uint64_t spans_ms[FLOOD_ROLLUP_TIERS] = {60000ULL, 3600000ULL, 86400000ULL};
+static const uint32_t sizes[FLOOD_ROLLUP_TIERS] = {FLOOD_ROLLUP_MINUTES, FLOOD_ROLLUP_HOURS, FLOOD_ROLLUP_DAYS};
+
+static uint32_t seed = 30;
+
+static uint32_t next_random(void)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+//Intervalo até a próxima amostra: quase sempre 500 ms, com pausas ocasionais de até 9 dias
+static uint64_t next_interval_ms(void)
+{
+    uint32_t r = next_random() % 1000;
+
+    if (r < 900) return 450 + next_random() % 100;
+    if (r < 970) return 1000 + next_random() % 120000;
+    if (r < 995) return 3600000ULL + next_random() % 7200000ULL;
+    return 86400000ULL * (1 + next_random() % 9);
+}
+
+//Recalcula a consulta percorrendo o histórico; only_current restringe ao bucket corrente
+static void brute_force(const sample_t *history, size_t count, int tier, int only_current, flood_rollup_stats_t *stats)
+{
+    uint64_t last = (history[count - 1].ms - START_MS) / spans_ms[tier];
+    uint64_t first = only_current ? last : (last + 1 >= sizes[tier] ? last + 1 - sizes[tier] : 0);
+    int64_t sum = 0;
+
+    stats->min_mm = 0;
+    stats->max_mm = 0;
+    stats->count = 0;
+    stats->rain_ms = 0;
+
+    for (size_t i = count; i-- > 0;)
+    {
+        uint64_t bucket = (history[i].ms - START_MS) / spans_ms[tier];
+        if (bucket < first) break;
+
+        if (stats->count == 0 || history[i].level_mm < stats->min_mm) stats->min_mm = history[i].level_mm;
+        if (stats->count == 0 || history[i].level_mm > stats->max_mm) stats->max_mm = history[i].level_mm;
+        stats->count++;
+        stats->rain_ms += history[i].rain_ms;
+        sum += history[i].level_mm;
+    }
+    stats->mean_mm = stats->count ? (int32_t)(sum / stats->count) : 0;
+}
+
+static int stats_differ(const flood_rollup_stats_t *a, const flood_rollup_stats_t *b)
+{
+    return a->min_mm != b->min_mm || a->max_mm != b->max_mm || a->mean_mm != b->mean_mm
+        || a->count != b->count || a->rain_ms != b->rain_ms;
+}
+
+int main(void)
+{
+    static flood_rollup_t rollup;
+    static sample_t history[SAMPLES];
+    flood_rollup_stats_t got, expected;
+    unsigned failures = 0;
+    uint64_t now = START_MS;
+    int32_t level = 5000;
+
+    flood_rollup_init(&rollup, START_MS);
+
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        uint32_t rain_x100 = next_random() % 10001;
+
+        if (i > 0) now += next_interval_ms();
+        level += (int32_t)(next_random() % 201) - 100;
+        if (level < 0) level = 0;
+        if (level > 10000) level = 10000;
+
+        history[i].ms = now;
+        history[i].level_mm = level;
+        history[i].rain_ms = i > 0 ? (uint64_t)rain_x100 * (now - history[i - 1].ms) : 0;
+        flood_rollup_update(&rollup, now, level, rain_x100);
+
+        for (int tier = 0; tier < FLOOD_ROLLUP_TIERS; tier++)
+        {
+            flood_rollup_window(&rollup, (flood_rollup_tier_t)tier, &got);
+            brute_force(history, i + 1, tier, 0, &expected);
+            if (stats_differ(&got, &expected) && failures++ < 10)
+                printf("janela difere na amostra %zu, resolucao %d\n", i, tier);
+
+            flood_rollup_current(&rollup, (flood_rollup_tier_t)tier, &got);
+            brute_force(history, i + 1, tier, 1, &expected);
+            if (stats_differ(&got, &expected) && failures++ < 10)
+                printf("bucket corrente difere na amostra %zu, resolucao %d\n", i, tier);
+        }
+    }
+
+    printf("%u diferencas em %d amostras (%.1f dias simulados)\n", failures, SAMPLES,
+           (now - START_MS) / 86400000.0);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * Regressão do framebuffer do SSD1306 (lib/ssd1306_gfx.c).
+ *
+ * - As telas de vRealTimeInfo (lib/flood_display.c) desenhadas com lib/ssd1306_gfx.c devem
+ *   ser idênticas, byte a byte, às desenhadas com as primitivas do driver original
+ *   (host/ssd1306_reference.c) e às imagens golden em host/images/.
+ * - Primitivas com coordenadas fora do display devem ser recortadas: o resultado é
+ *   comparado com a imagem golden edges.pbm e, no build com ASan/UBSan, não pode haver
+ *   acesso fora do buffer.
+ * - O transporte (lib/ssd1306.c, com o stub de hardware/i2c.h) deve enviar ao display os
+ *   mesmos comandos do driver original, agrupados em uma transação, e o framebuffer em
+ *   uma única transação de dados.
+ *
+ * Uso:
+ *   test_ssd1306 <diretorio das imagens> [--write-golden]
+ */
+#include <stdio.h>
+#include <string.h>
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_reference.h"
+
+#define PATH_SIZE 512
+
+static const char *images_dir;
+static bool write_golden;
+static unsigned failures;
+
+//Número de pixels acesos no framebuffer
+static unsigned lit_pixels(const ssd1306_t *ssd)
+{
+  unsigned count = 0;
+  for (size_t i = 1; i < ssd->bufsize; i++)
+    count += __builtin_popcount(ssd->ram_buffer[i]);
+  return count;
+}
+
+static bool get_pixel(const ssd1306_t *ssd, int x, int y)
+{
+  return ssd->ram_buffer[(y >> 3) + x * ssd->pages + 1] & (1 << (y & 0b111));
+}
+
+//Gera a imagem em PBM texto (P1), 1 = pixel aceso
+static size_t pbm_format(const ssd1306_t *ssd, char *out, size_t size)
+{
+  size_t length = (size_t)snprintf(out, size, "P1\n%u %u\n", ssd->width, ssd->height);
+
+  for (int y = 0; y < ssd->height; y++)
+  {
+    for (int x = 0; x < ssd->width && length + 2 < size; x++)
+    {
+      out[length++] = get_pixel(ssd, x, y) ? '1' : '0';
+      if (x % 64 == 63 || x == ssd->width - 1) out[length++] = '\n';
+    }
+  }
+  out[length] = '\0';
+  return length;
+}
+
+//Compara o framebuffer com a imagem golden (ou grava a imagem com --write-golden)
+static void check_golden(const ssd1306_t *ssd, const char *name)
+{
+  static char image[WIDTH * HEIGHT * 2], expected[WIDTH * HEIGHT * 2];
+  char path[PATH_SIZE];
+  size_t length = pbm_format(ssd, image, sizeof(image)), read;
+  FILE *file;
+
+  snprintf(path, sizeof(path), "%s/%s.pbm", images_dir, name);
+
+  if (write_golden)
+  {
+    file = fopen(path, "wb");
+    if (!file || fwrite(image, 1, length, file) != length)
+    {
+      printf("nao foi possivel gravar %s\n", path);
+      failures++;
+    }
+    if (file) fclose(file);
+    return;
+  }
+
+  file = fopen(path, "rb");
+  if (!file)
+  {
+    printf("golden nao encontrado: %s\n", path);
+    failures++;
+    return;
+  }
+  read = fread(expected, 1, sizeof(expected), file);
+  fclose(file);
+
+  if (read != length || memcmp(image, expected, length) != 0)
+  {
+    printf("%s difere do golden %s\n", name, path);
+    failures++;
+  }
+}
+
+static void check(bool condition, const char *description)
+{
+  if (!condition)
+  {
+    printf("falhou: %s\n", description);
+    failures++;
+  }
+}
+
+//Telas da firmware: idênticas ao driver original e às imagens golden
+static void test_screens(void)
+{
+  static const char *statuses[] = {"SEGURO", "ATENCAO", "ALERTA", "PERIGO"};
+  static const float values[][2] = {{5.00f, 10.09f}, {7.35f, 62.50f}, {10.00f, 100.00f}, {0.00f, 0.00f}};
+  ssd1306_t driver, reference;
+  char name[32];
+
+  ssd1306_init(&driver, WIDTH, HEIGHT, false, 0x3C, NULL);
+  ssd1306_init(&reference, WIDTH, HEIGHT, false, 0x3C, NULL);
+
+  for (int i = 0; i < 4; i++)
+  {
+    flood_display_info(&flood_display_ssd1306, &driver, statuses[i], values[i][0], values[i][1]);
+    flood_display_info(&gfx_reference, &reference, statuses[i], values[i][0], values[i][1]);
+    snprintf(name, sizeof(name), "info_%s", statuses[i]);
+    if (memcmp(driver.ram_buffer, reference.ram_buffer, driver.bufsize) != 0)
+    {
+      printf("%s difere do driver original\n", name);
+      failures++;
+    }
+    check_golden(&driver, name);
+  }
+
+  flood_display_alert(&flood_display_ssd1306, &driver);
+  flood_display_alert(&gfx_reference, &reference);
+  check(memcmp(driver.ram_buffer, reference.ram_buffer, driver.bufsize) == 0, "tela de alerta igual ao driver original");
+  check_golden(&driver, "alert");
+
+  //Caracteres em todas as linhas (alinhadas ou não) dentro do display
+  for (int y = 0; y + 8 <= HEIGHT; y++)
+  {
+    ssd1306_fill(&driver, false);
+    reference_fill(&reference, false);
+    for (int x = 0; x + 8 <= WIDTH; x += 9)
+    {
+      char c = (char)(' ' + (x + y) % 95);
+      ssd1306_draw_char(&driver, c, (uint8_t)x, (uint8_t)y);
+      reference_draw_char(&reference, c, (uint8_t)x, (uint8_t)y);
+    }
+    if (memcmp(driver.ram_buffer, reference.ram_buffer, driver.bufsize) != 0)
+    {
+      printf("caracteres em y=%d diferem do driver original\n", y);
+      failures++;
+    }
+  }
+
+  free(driver.ram_buffer);
+  free(reference.ram_buffer);
+}
+
+//Coordenadas fora do display: apenas a parte visível é desenhada
+static void test_edges(void)
+{
+  ssd1306_t ssd;
+
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL);
+
+  //Totalmente fora: nenhum pixel pode voltar para o início do display
+  ssd1306_rect(&ssd, 0, 200, 100, 10, true, false);
+  check(lit_pixels(&ssd) == 0, "retangulo em x=200 nao acende pixels");
+  ssd1306_rect(&ssd, 200, 0, 10, 50, true, true);
+  check(lit_pixels(&ssd) == 0, "retangulo em y=200 nao acende pixels");
+  ssd1306_draw_char(&ssd, 'A', 250, 0);
+  ssd1306_draw_char(&ssd, 'A', 0, 250);
+  check(lit_pixels(&ssd) == 0, "caractere em x=250 ou y=250 nao acende pixels");
+  ssd1306_pixel(&ssd, 128, 0, true);
+  ssd1306_pixel(&ssd, 0, 64, true);
+  ssd1306_pixel(&ssd, 255, 255, true);
+  check(lit_pixels(&ssd) == 0, "pixels fora do display sao descartados");
+
+  //Parcialmente visível
+  ssd1306_rect(&ssd, 60, 120, 100, 100, true, true);
+  check(lit_pixels(&ssd) == 8 * 4, "retangulo recortado no canto inferior direito");
+  ssd1306_rect(&ssd, 10, 100, 155, 20, true, false);
+  ssd1306_line(&ssd, 0, 0, 255, 255, true);
+  ssd1306_line(&ssd, 255, 0, 0, 40, true);
+  ssd1306_hline(&ssd, 90, 255, 50, true);
+  ssd1306_vline(&ssd, 70, 20, 255, true);
+  ssd1306_draw_char(&ssd, 'B', 124, 20);
+  ssd1306_draw_char(&ssd, 'C', 60, 60);
+  ssd1306_draw_char(&ssd, 'D', 30, 3);
+  ssd1306_draw_string(&ssd, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 80, 36);
+  check_golden(&ssd, "edges");
+
+  free(ssd.ram_buffer);
+}
+
+//Comandos e transações enviados pelo transporte, comparados com o driver original
+static void test_transport(void)
+{
+  ssd1306_t ssd;
+  i2c_inst_t bus, reference;
+
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, &bus);
+
+  //Configuração: mesma sequência de comandos, em uma única transação
+  i2c_stub_reset(&bus);
+  ssd1306_config(&ssd);
+  ssd.i2c_port = &reference;
+  i2c_stub_reset(&reference);
+  reference_config(&ssd);
+  ssd.i2c_port = &bus;
+  printf("ssd1306_config: %zu bytes em %u transacoes (original: %zu bytes em %u)\n",
+         bus.bytes, bus.transactions, reference.bytes, reference.transactions);
+  check(bus.transactions == 1 && bus.control[0] == 0x00, "configuracao em uma transacao de comandos");
+  check(bus.bytes == bus.command_count + 1, "configuracao com um unico byte de controle");
+  check(bus.command_count == reference.command_count
+        && memcmp(bus.commands, reference.commands, bus.command_count) == 0,
+        "configuracao envia os mesmos comandos do driver original");
+
+  //Atualização: comandos de endereço em uma transação e o framebuffer em outra
+  i2c_stub_reset(&bus);
+  ssd1306_send_data(&ssd);
+  ssd.i2c_port = &reference;
+  i2c_stub_reset(&reference);
+  reference_send_data(&ssd);
+  ssd.i2c_port = &bus;
+  printf("ssd1306_send_data: %zu bytes em %u transacoes (original: %zu bytes em %u)\n",
+         bus.bytes, bus.transactions, reference.bytes, reference.transactions);
+  check(bus.transactions == 2, "atualizacao em duas transacoes");
+  check(bus.control[0] == 0x00 && bus.length[0] == bus.command_count + 1, "comandos de endereco em uma transacao");
+  check(bus.control[1] == 0x40 && bus.length[1] == ssd.bufsize, "framebuffer em uma transacao de dados");
+  check(bus.command_count == reference.command_count
+        && memcmp(bus.commands, reference.commands, bus.command_count) == 0,
+        "atualizacao envia os mesmos comandos de endereco do driver original");
+
+  free(ssd.ram_buffer);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "uso: %s <diretorio das imagens> [--write-golden]\n", argv[0]);
+    return 2;
+  }
+  images_dir = argv[1];
+  write_golden = argc > 2 && strcmp(argv[2], "--write-golden") == 0;
+
+  test_screens();
+  test_edges();
+  test_transport();
+
+  printf("%u falhas\n", failures);
+  return failures ? 1 : 0;
+}
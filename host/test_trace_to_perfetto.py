@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Regressão de tools/trace_to_perfetto.py.
+
+Monta uma captura sintética da serial com dois blocos #TRACE, como os enviados por
+trace_dump, e verifica a linha do tempo gerada:
+- a task em execução no fim de cada bloco tem o trecho fechado no último evento;
+- o estouro do contador de 32 bits dentro de um bloco é corrigido, e o estado da
+  correção não passa para o bloco seguinte;
+- com o buffer circular sobrescrito (linha L), o fim de trecho cujo início foi
+  perdido é descartado e os eventos perdidos de cada bloco são informados.
+
+Uso:
+    test_trace_to_perfetto.py <tools/trace_to_perfetto.py>
+"""
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+TASK_SWITCH_IN = 1
+QUEUE_SEND = 2
+SPAN_BEGIN = 8
+SPAN_END = 9
+
+READ_TASK = 0x20001000
+DISPLAY_TASK = 0x20002000
+QUEUE = 0x20003000
+
+failures = 0
+
+
+def check(condition, description):
+    global failures
+    if not condition:
+        print("falhou: %s" % description)
+        failures += 1
+
+
+def event(timestamp, kind, arg):
+    return "E %08x %x %08x" % (timestamp, kind, arg)
+
+
+def capture():
+    lines = ["boot: mensagens fora do bloco sao ignoradas"]
+
+    # Bloco 1: a leitura roda até perto do estouro do contador e o display continua depois dele
+    lines += ["#TRACE BEGIN", "N %08x ReadTask" % READ_TASK, "N %08x DisplayTask" % DISPLAY_TASK,
+              "N %08x JoystickQueue" % QUEUE]
+    lines += [event(0xFFFFFF00, TASK_SWITCH_IN, READ_TASK),
+              event(0xFFFFFF10, SPAN_BEGIN, 0),
+              event(0xFFFFFF40, SPAN_END, 0),
+              event(0xFFFFFF50, QUEUE_SEND, QUEUE),
+              event(0x00000010, TASK_SWITCH_IN, DISPLAY_TASK),
+              event(0x00000030, SPAN_BEGIN, 1),
+              event(0x00000100, QUEUE_SEND, QUEUE)]
+    lines += ["L 0", "#TRACE END"]
+
+    lines.append("R: 5.00")
+
+    # Bloco 2: o buffer foi sobrescrito; começa com o fim de um trecho cujo início se perdeu
+    lines += ["#TRACE BEGIN", "N %08x ReadTask" % READ_TASK, "N %08x DisplayTask" % DISPLAY_TASK]
+    lines += [event(0x00000050, SPAN_END, 1),
+              event(0x00000060, TASK_SWITCH_IN, READ_TASK),
+              event(0x00000070, SPAN_BEGIN, 3),
+              event(0x00000090, SPAN_END, 3),
+              event(0x000000A0, TASK_SWITCH_IN, DISPLAY_TASK),
+              event(0x000000C0, QUEUE_SEND, QUEUE)]
+    lines += ["L 37", "#TRACE END"]
+    return "\n".join(lines) + "\n"
+
+
+def slices(trace, tid):
+    return [(e["ts"], e["dur"]) for e in trace if e["ph"] == "X" and e["tid"] == tid]
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        return 2
+
+    with tempfile.NamedTemporaryFile("w", suffix=".txt", delete=False) as out:
+        out.write(capture())
+        path = out.name
+    try:
+        result = subprocess.run([sys.executable, sys.argv[1], path], capture_output=True, text=True)
+    finally:
+        os.unlink(path)
+
+    check(result.returncode == 0, "conversor termina sem erro")
+    if result.returncode != 0:
+        print(result.stderr)
+        return 1
+    document = json.loads(result.stdout)
+    trace = document["traceEvents"]
+    wrap = 1 << 32
+
+    # Bloco 1: trecho da leitura até a troca após o estouro e trecho final do display fechado
+    check(slices(trace, READ_TASK)[0] == (0xFFFFFF00, 0x110), "trecho da leitura atravessa o estouro do contador")
+    check((wrap + 0x10, 0xF0) in slices(trace, DISPLAY_TASK), "ultimo trecho do bloco 1 fechado no ultimo evento")
+    sends = sorted(e["ts"] for e in trace if e["name"] == "queue send")
+    check(sends[:2] == [0xC0, 0xFFFFFF50], "bloco 2 nao herda a correcao do estouro do bloco 1")
+    check(sends[2] == wrap + 0x100, "eventos apos o estouro recebem o deslocamento de 2^32")
+
+    # Trecho aberto no fim do bloco 1 (ssd1306_send_data) é fechado no último evento
+    display = [(e["ph"], e["ts"]) for e in trace if e.get("name") == "ssd1306_send_data"]
+    check(display == [("B", wrap + 0x30), ("E", wrap + 0x100)], "trecho aberto fechado no fim do bloco")
+
+    # Bloco 2: fim isolado descartado, trechos completos mantidos e última task fechada
+    check(not any(e["ph"] == "E" and e["ts"] == 0x50 for e in trace), "fim de trecho sem inicio e descartado")
+    forecast = [(e["ph"], e["ts"], e["tid"]) for e in trace if e.get("name") == "flood_forecast_update"]
+    check(forecast == [("B", 0x70, READ_TASK), ("E", 0x90, READ_TASK)], "trecho da previsao na task de leitura")
+    check(slices(trace, READ_TASK)[1] == (0x60, 0x40), "trecho da leitura no bloco 2")
+    check((0xA0, 0x20) in slices(trace, DISPLAY_TASK), "ultimo trecho do bloco 2 fechado no ultimo evento")
+
+    # Contagem de eventos perdidos por bloco
+    check(document["otherData"] == {"blocks": 2, "lost_events": 37}, "total de eventos perdidos")
+    check("bloco 2: 37 eventos perdidos" in result.stderr, "aviso de eventos perdidos no bloco 2")
+    check("bloco 1" not in result.stderr, "nenhum aviso para o bloco 1")
+
+    names = {e["tid"]: e["args"]["name"] for e in trace if e["ph"] == "M"}
+    check(names.get(READ_TASK) == "ReadTask" and names.get(DISPLAY_TASK) == "DisplayTask", "nomes das tasks")
+
+    print("%d falhas" % failures)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
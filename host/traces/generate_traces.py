@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Gera os traces sintéticos de ADC usados pelos testes de regressão do host.
+
+Os valores simulam as leituras brutas do Joystick (eixo X = chuva, eixo Y = nível
+do rio), uma amostra a cada 500 ms, como em vReadJoystickValuesTask. O ruído usa
+um gerador congruente linear próprio para que os arquivos sejam reproduzíveis.
+
+Uso:
+    python3 host/traces/generate_traces.py
+
+Formatos:
+    .csv  linhas "adc_x,adc_y" (linhas iniciadas por '#' são comentários)
+    .bin  pares de uint16 little-endian (adc_x, adc_y)
+"""
+import os
+import struct
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ADC_CENTER = 2048
+ADC_MAX = 4095
+
+
+class Lcg:
+    def __init__(self, seed):
+        self.state = seed
+
+    def next(self):
+        self.state = (self.state * 1103515245 + 12345) & 0x7FFFFFFF
+        return self.state
+
+    def noise(self, lsb):
+        return (self.next() % (2 * lsb + 1)) - lsb
+
+
+def river_to_adc(river):
+    """Inverte flood_normalize para níveis acima do normal (5 m)."""
+    if river <= 5.0:
+        return int(round(ADC_CENTER - (5.0 - river) * (ADC_CENTER - 1) / 5.0))
+    return int(round(ADC_CENTER + (river - 5.0) * (ADC_CENTER - 1) / 5.0))
+
+
+def rain_to_adc(rain):
+    return int(round(rain * ADC_MAX / 100.0))
+
+
+def clamp(value):
+    return max(0, min(ADC_MAX, value))
+
+
+def flood_event():
+    """Cheia de 1 h: chuva aumenta, o rio sobe de 5 m até 9,5 m e depois baixa."""
+    rng = Lcg(26)
+    samples = []
+    for i in range(7200):
+        minute = i / 120.0
+        if minute < 10:
+            rain, river = 10 + minute * 5, 5.0
+        elif minute < 35:
+            rain, river = 60 + (minute - 10), 5.0 + (minute - 10) * 0.18
+        elif minute < 45:
+            rain, river = 85 - (minute - 35) * 6, 9.5
+        else:
+            rain, river = max(0.0, 25 - (minute - 45)), 9.5 - (minute - 45) * 0.3
+        samples.append((clamp(rain_to_adc(rain) + rng.noise(4)), clamp(river_to_adc(river) + rng.noise(2))))
+    return samples
+
+
+def steady_noise():
+    """Rio parado em ~8,5 m com ruído de ±3 LSB e chuva fraca: nada deve mudar."""
+    rng = Lcg(29)
+    return [(clamp(rain_to_adc(30) + rng.noise(3)), clamp(river_to_adc(8.5) + rng.noise(3)))
+            for _ in range(2000)]
+
+
+def flash_flood():
+    """Enxurrada: chuva máxima e subida rápida de 5 m para 9,8 m em 5 minutos."""
+    rng = Lcg(31)
+    samples = []
+    for i in range(1200):
+        minute = i / 120.0
+        river = 5.0 if minute < 2 else min(9.8, 5.0 + (minute - 2) * 0.96)
+        samples.append((clamp(ADC_MAX + rng.noise(2)), clamp(river_to_adc(river) + rng.noise(2))))
+    return samples
+
+
+def deadzone_noise():
+    """Rio parado na borda inferior da zona morta (ADC 1800, ~4,39 m) com ruído de ±3 LSB."""
+    rng = Lcg(290)
+    return [(clamp(rain_to_adc(30) + rng.noise(3)), clamp(1800 + rng.noise(3))) for _ in range(20000)]
+
+
+def threshold_noise():
+    """Rio parado sobre limiares com ruído de ±3 LSB: 9,0 m (PERIGO) e a borda da zona morta (ADC 2100)."""
+    rng = Lcg(27)
+    samples = [(clamp(rain_to_adc(30) + rng.noise(3)), clamp(3686 + rng.noise(3))) for _ in range(2000)]
+    samples += [(clamp(rain_to_adc(30) + rng.noise(3)), clamp(2100 + rng.noise(3))) for _ in range(2000)]
+    return samples
+
+
+def write_csv(name, description, samples):
+    with open(os.path.join(HERE, name), "w", encoding="utf-8") as out:
+        out.write("# %s\n# adc_x,adc_y\n" % description)
+        for x, y in samples:
+            out.write("%d,%d\n" % (x, y))
+
+
+def write_bin(name, samples):
+    with open(os.path.join(HERE, name), "wb") as out:
+        for x, y in samples:
+            out.write(struct.pack("<HH", x, y))
+
+
+if __name__ == "__main__":
+    write_csv("flood_event.csv", "Cheia sintetica de 1 h (500 ms por amostra)", flood_event())
+    write_csv("steady_noise.csv", "Rio parado em 8,5 m com ruido de +-3 LSB", steady_noise())
+    write_bin("flash_flood.bin", flash_flood())
+    write_bin("deadzone_noise.bin", deadzone_noise())
+    write_csv("threshold_noise.csv", "Rio parado sobre os limiares de 9 m e da zona morta com ruido de +-3 LSB",
+              threshold_noise())
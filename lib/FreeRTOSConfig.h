@@ -134,5 +134,8 @@
  #define INCLUDE_xQueueGetMutexHolder            1
  
  /* A header file that defines trace macro can be included here. */
+ #ifndef __ASSEMBLER__
+ #include "rtos_trace.h"
+ #endif
  
  #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
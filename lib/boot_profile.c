@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "boot_profile.h"
+
+static uint64_t boot_times_us[BOOT_PHASES]; //0 indica fase ainda não atingida
+
+static const char *boot_phase_names[BOOT_PHASES] = {
+    "main",
+    "scheduler",
+    "primeira amostra",
+    "primeira classificacao",
+    "primeira atuacao",
+    "primeiro display"
+};
+
+/**
+ * @brief Registra o instante da primeira ocorrência de uma fase
+ */
+void boot_profile_mark(boot_phase_t phase)
+{
+    if (boot_times_us[phase] == 0) boot_times_us[phase] = time_us_64();
+}
+
+/**
+ * @brief Verifica se todas as fases já foram registradas
+ */
+bool boot_profile_complete(void)
+{
+    for (int i = 0; i < BOOT_PHASES; i++)
+    {
+        if (boot_times_us[i] == 0) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Envia pela serial o instante de cada fase e o intervalo desde a fase anterior
+ */
+void boot_profile_report(void)
+{
+    uint64_t previous = 0;
+
+    printf("Boot (us desde o reset):\n");
+    for (int i = 0; i < BOOT_PHASES; i++)
+    {
+        printf("  %-24s %10llu (+%llu)\n", boot_phase_names[i],
+               (unsigned long long)boot_times_us[i], (unsigned long long)(boot_times_us[i] - previous));
+        previous = boot_times_us[i];
+    }
+}
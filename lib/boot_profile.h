@@ -0,0 +1,29 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Marcação do tempo das fases do boot, contado a partir do reset (timer do RP2040).
+ *
+ * Cada fase guarda apenas a primeira ocorrência, então as marcações podem ficar
+ * dentro dos laços das tasks sem custo relevante após o boot.
+ */
+
+//Fases do boot, na ordem em que devem ocorrer
+typedef enum {
+    BOOT_MAIN = 0, //Entrada da função main
+    BOOT_SCHEDULER, //Primeira task em execução
+    BOOT_FIRST_SAMPLE, //Primeira leitura dos sensores
+    BOOT_FIRST_CLASSIFICATION, //Primeiro status calculado
+    BOOT_FIRST_ACTUATION, //Primeira atualização de LEDs/buzzer
+    BOOT_FIRST_DISPLAY, //Primeira atualização do display
+    BOOT_PHASES
+} boot_phase_t;
+
+void boot_profile_mark(boot_phase_t phase);
+bool boot_profile_complete(void);
+void boot_profile_report(void);
+
+#endif
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include "flood_display.h"
+
+const flood_display_gfx_t flood_display_ssd1306 = {ssd1306_fill, ssd1306_rect, ssd1306_line, ssd1306_draw_string};
+
+// Apenas desenha no framebuffer; o envio ao display é feito com ssd1306_send_data
+void flood_display_info(const flood_display_gfx_t *gfx, ssd1306_t *ssd, const char *status, float river, float rain) {
+  char level_river[20], rain_in[20];
+  bool cor = true;
+  snprintf(level_river, sizeof(level_river), "%.2f", river);
+  snprintf(rain_in, sizeof(rain_in), "%.2f", rain);
+
+  // Limpa o display (preenche com cor inversa)
+  gfx->fill(ssd, !cor);
+  // Moldura externa
+  gfx->rect(ssd, 3, 3, 122, 60, cor, !cor);
+  // Linha abaixo do título "STATUS"
+  gfx->line(ssd, 3, 14, 122, 14, cor);
+  // Linha abaixo da palavra "PERIGO"
+  gfx->line(ssd, 3, 30, 122, 30, cor);
+  // Linha horizontal separando as duas linhas da "tabela"
+  gfx->line(ssd, 3, 45, 122, 45, cor);
+  // Linha vertical da tabela, separando letra e número
+  gfx->line(ssd, 25, 30, 25, 60, cor);
+  // Texto no topo (status)
+  gfx->draw_string(ssd, "status", 45, 5);
+  // Palavra que indica o status atual
+  gfx->draw_string(ssd, status, 35, 18);
+  // Primeira linha da tabela: R e Valor do nível
+  gfx->draw_string(ssd, "R", 10, 34);
+  gfx->draw_string(ssd, level_river, 30, 34);
+  // Segunda linha da tabela: C e valor da intensidade de chuva
+  gfx->draw_string(ssd, "C", 10, 49);
+  gfx->draw_string(ssd, rain_in, 30, 49);
+}
+
+void flood_display_alert(const flood_display_gfx_t *gfx, ssd1306_t *ssd) {
+  bool cor = true;
+
+  gfx->fill(ssd, !cor);                          // Limpa o display
+  gfx->rect(ssd, 3, 3, 122, 60, cor, !cor);      // Desenha um retângulo
+  gfx->draw_string(ssd, "RISCO ALTO", 10, 32);   // Desenha uma string
+}
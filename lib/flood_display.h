@@ -0,0 +1,29 @@
+#ifndef FLOOD_DISPLAY_H
+#define FLOOD_DISPLAY_H
+
+#include "ssd1306.h"
+
+/**
+ * Telas do monitoramento exibidas no SSD1306 por vRealTimeInfo.
+ *
+ * As telas são desenhadas por uma tabela de primitivas, para que os testes e
+ * benchmarks do host (host/) possam desenhar o mesmo layout também com o driver
+ * original e comparar os resultados. A firmware usa flood_display_ssd1306.
+ */
+
+// Primitivas de desenho usadas pelas telas
+typedef struct {
+  void (*fill)(ssd1306_t *ssd, bool value);
+  void (*rect)(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
+  void (*line)(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
+  void (*draw_string)(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+} flood_display_gfx_t;
+
+extern const flood_display_gfx_t flood_display_ssd1306; // Primitivas de ssd1306_gfx.c
+
+// Status atual e tabela com o nível do rio (R) e a intensidade de chuva (C)
+void flood_display_info(const flood_display_gfx_t *gfx, ssd1306_t *ssd, const char *status, float river, float rain);
+// Tela do modo de alerta
+void flood_display_alert(const flood_display_gfx_t *gfx, ssd1306_t *ssd);
+
+#endif
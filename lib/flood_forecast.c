@@ -0,0 +1,146 @@
+#include "flood_forecast.h"
+
+//Limiares de nível em micrômetros, na ordem de flood_forecast_threshold_t
+static const int32_t flood_forecast_thresholds[FLOOD_FORECAST_THRESHOLDS] = {
+    (int32_t)(FLOOD_RIVER_NORMAL * 1000000),
+    (int32_t)(FLOOD_RIVER_HIGH * 1000000),
+    (int32_t)(FLOOD_RIVER_DANGER * 1000000)
+};
+
+//Verifica se o limiar ainda não foi atingido, mas deve ser dentro do horizonte de previsão
+static bool flood_forecast_imminent(const flood_forecast_t *forecast, flood_forecast_threshold_t threshold)
+{
+    return forecast->eta_s[threshold] > 0 && forecast->eta_s[threshold] <= FLOOD_FORECAST_HORIZON_S;
+}
+
+/**
+ * Status indicado pela amostra atual, antes da confirmação: um limiar previsto para ser
+ * atingido dentro de FLOOD_FORECAST_HORIZON_S indica PERIGO para 9 m, ALERTA para 7 m e
+ * ATENCAO para o nível normal. Limiares já atingidos ficam a cargo de flood_classify
+ */
+static flood_status_t flood_forecast_candidate(const flood_forecast_t *forecast)
+{
+    if (flood_forecast_imminent(forecast, FLOOD_FORECAST_DANGER)) return FLOOD_PERIGO;
+    if (flood_forecast_imminent(forecast, FLOOD_FORECAST_HIGH)) return FLOOD_ALERTA;
+    if (flood_forecast_imminent(forecast, FLOOD_FORECAST_NORMAL)) return FLOOD_ATENCAO;
+
+    return FLOOD_SEGURO;
+}
+
+/**
+ * @brief Reinicia a previsão
+ *
+ * @param period_ms Intervalo entre as amostras passadas para flood_forecast_update
+ */
+void flood_forecast_init(flood_forecast_t *forecast, uint32_t period_ms)
+{
+    forecast->level = 0;
+    forecast->rate = 0;
+    forecast->rain_rate = 0;
+    forecast->period_ms = period_ms;
+    forecast->primed = false;
+    forecast->status = FLOOD_SEGURO;
+    forecast->candidate = FLOOD_SEGURO;
+    forecast->persist = 0;
+    forecast->outliers = 0;
+
+    for (int i = 0; i < FLOOD_FORECAST_THRESHOLDS; i++) forecast->eta_s[i] = FLOOD_FORECAST_NEVER;
+}
+
+/**
+ * @brief Atualiza a estimativa com uma nova amostra e recalcula os tempos até cada limiar
+ *
+ * @param level_mm Nível do rio medido (mm)
+ * @param rain_x100 Intensidade da chuva em centésimos (0 a 10000)
+ */
+void flood_forecast_update(flood_forecast_t *forecast, int32_t level_mm, int32_t rain_x100)
+{
+    int32_t level_um = level_mm * 1000;
+    int32_t predicted, residual, rate;
+    uint32_t samples;
+    flood_status_t status;
+
+    //Chuva acima do limiar de chuva forte é tratada como entrada de controle (subida esperada)
+    forecast->rain_rate = rain_x100 > (int32_t)(FLOOD_RAIN_HIGH * 100)
+                        ? (rain_x100 - (int32_t)(FLOOD_RAIN_HIGH * 100)) * FLOOD_FORECAST_RAIN_GAIN
+                        : 0;
+
+    //Previsão: nível anterior somado à taxa estimada
+    predicted = forecast->level + (forecast->rate + forecast->rain_rate) / 256;
+    residual = level_um - predicted;
+
+    //Erro acima do limite em amostras seguidas indica um degrau real no nível
+    if (residual > FLOOD_FORECAST_MAX_RESIDUAL || residual < -FLOOD_FORECAST_MAX_RESIDUAL)
+    {
+        forecast->outliers++;
+    }else {
+        forecast->outliers = 0;
+    }
+
+    if (!forecast->primed)
+    {
+        forecast->level = level_um;
+        forecast->rate = 0;
+        forecast->outliers = 0;
+        forecast->primed = true;
+    }else if (forecast->outliers >= FLOOD_FORECAST_RESEED_SAMPLES)
+    {
+        //Degrau: o nível passa a ser a medida e a taxa aprendida é mantida
+        forecast->level = level_um;
+        forecast->outliers = 0;
+    }else {
+        //Correção: parte do erro ajusta o nível e parte ajusta a taxa
+        if (residual > FLOOD_FORECAST_MAX_RESIDUAL) residual = FLOOD_FORECAST_MAX_RESIDUAL;
+        if (residual < -FLOOD_FORECAST_MAX_RESIDUAL) residual = -FLOOD_FORECAST_MAX_RESIDUAL;
+
+        forecast->level = predicted + residual / (1 << FLOOD_FORECAST_ALPHA_SHIFT);
+        forecast->rate += residual * 256 / (1 << FLOOD_FORECAST_BETA_SHIFT);
+    }
+
+    rate = forecast->rate + forecast->rain_rate;
+    for (int i = 0; i < FLOOD_FORECAST_THRESHOLDS; i++)
+    {
+        if (forecast->level >= flood_forecast_thresholds[i])
+        {
+            forecast->eta_s[i] = 0;
+        }else if (rate < FLOOD_FORECAST_MIN_RATE){
+            forecast->eta_s[i] = FLOOD_FORECAST_NEVER;
+        }else {
+            //Distância até o limiar em Q8 dividida pela taxa resulta no número de amostras
+            samples = ((uint32_t)(flood_forecast_thresholds[i] - forecast->level) << 8) / (uint32_t)rate;
+            //Arredonda para cima para que um limiar ainda não atingido nunca tenha tempo 0
+            forecast->eta_s[i] = samples > (FLOOD_FORECAST_NEVER - 1000) / forecast->period_ms
+                               ? FLOOD_FORECAST_NEVER
+                               : (samples * forecast->period_ms + 999) / 1000;
+        }
+    }
+
+    //O status previsto só muda depois de se manter por FLOOD_FORECAST_PERSIST_SAMPLES amostras
+    status = flood_forecast_candidate(forecast);
+    if (status == forecast->status)
+    {
+        forecast->persist = 0;
+    }else if (status != forecast->candidate){
+        forecast->candidate = status;
+        forecast->persist = 1;
+    }else {
+        forecast->persist++;
+    }
+    if (forecast->persist >= FLOOD_FORECAST_PERSIST_SAMPLES)
+    {
+        forecast->status = status;
+        forecast->persist = 0;
+    }
+}
+
+/**
+ * @brief Retorna o status mínimo indicado pela previsão
+ *
+ * O status escala o alerta antes que o rio chegue ao limiar, mas só muda depois de se
+ * manter por FLOOD_FORECAST_PERSIST_SAMPLES amostras, evitando que o ruído do ADC
+ * ligue e desligue o alerta
+ */
+flood_status_t flood_forecast_status(const flood_forecast_t *forecast)
+{
+    return forecast->status;
+}
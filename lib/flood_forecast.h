@@ -0,0 +1,109 @@
+#ifndef FLOOD_FORECAST_H
+#define FLOOD_FORECAST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "flood_pipeline.h"
+
+/**
+ * Previsão incremental do nível do rio.
+ *
+ * Um filtro alfa-beta (Kalman de regime permanente) em ponto fixo estima o nível
+ * e a taxa de subida do rio a cada amostra, usando a chuva forte como entrada de
+ * controle. A partir da estimativa calcula o tempo previsto até cada limiar de
+ * classificação. Todas as operações são inteiras e O(1) por amostra.
+ *
+ * Unidades: entradas inteiras (nível em mm e chuva em centésimos, como produzidos por
+ * flood_normalize_fixed); internamente nível em micrômetros (um) e taxa em um/amostra
+ * no formato Q8.
+ */
+
+#define FLOOD_FORECAST_ALPHA_SHIFT 4 //Ganho de nível do filtro: 1/16
+#define FLOOD_FORECAST_BETA_SHIFT 10 //Ganho de taxa do filtro: 1/1024
+
+//Um passo do ADC equivale a cerca de 2,4 mm de nível (5 m / 2047)
+#define FLOOD_FORECAST_LSB_UM ((int32_t)(FLOOD_RIVER_NORMAL * 1000000) / (FLOOD_ADC_CENTER - 1))
+
+/**
+ * Limite do erro de previsão por amostra, em passos do ADC. Saltos isolados maiores que
+ * isso (ruído, leitura espúria) movem a estimativa apenas pelo limite. Se o erro passar
+ * do limite por FLOOD_FORECAST_RESEED_SAMPLES amostras seguidas, o nível mudou de fato
+ * (ex.: Joystick solto de uma vez) e o nível estimado é reiniciado na medida atual,
+ * mantendo a taxa aprendida, em vez de seguir o degrau lentamente e oscilar
+ */
+#ifndef FLOOD_FORECAST_MAX_RESIDUAL_LSB
+#define FLOOD_FORECAST_MAX_RESIDUAL_LSB 16
+#endif
+#ifndef FLOOD_FORECAST_RESEED_SAMPLES
+#define FLOOD_FORECAST_RESEED_SAMPLES 4
+#endif
+#define FLOOD_FORECAST_MAX_RESIDUAL (FLOOD_FORECAST_LSB_UM * FLOOD_FORECAST_MAX_RESIDUAL_LSB)
+
+/**
+ * Taxa mínima (Q8 um/amostra) considerada subida: 1 passo do ADC a cada 20 amostras
+ * (~0,9 m/h). Abaixo disso a estimativa é dominada pelo ruído de quantização do ADC
+ */
+#ifndef FLOOD_FORECAST_MIN_RATE
+#define FLOOD_FORECAST_MIN_RATE (FLOOD_FORECAST_LSB_UM * 256 / 20)
+#endif
+
+//Número de amostras seguidas em que um novo status previsto deve se manter antes de valer
+#ifndef FLOOD_FORECAST_PERSIST_SAMPLES
+#define FLOOD_FORECAST_PERSIST_SAMPLES 10
+#endif
+
+#ifndef FLOOD_FORECAST_RAIN_GAIN
+#define FLOOD_FORECAST_RAIN_GAIN 3 //Subida esperada (Q8 um/amostra) por centésimo de chuva acima de FLOOD_RAIN_HIGH
+#endif
+
+#ifndef FLOOD_FORECAST_HORIZON_S
+#define FLOOD_FORECAST_HORIZON_S 600 //Antecedência (s) com que o alerta é escalado pela previsão
+#endif
+
+/**
+ * Orçamento de ciclos do Cortex-M0+ (RP2040 a 125 MHz) para uma chamada de
+ * flood_forecast_update: 1000 ciclos (8 us), menos de 0,002% do período de amostragem.
+ *
+ * Estimativa do pior caso: ~150 ciclos no filtro e na persistência e, com o rio subindo,
+ * três divisões por limiar no cálculo dos tempos (o M0+ não tem instrução de divisão; o
+ * SDK usa o divisor por hardware do RP2040, ~30 ciclos por divisão), cerca de 420 ciclos
+ * no total. No host (x86) a mesma função custa ~30 ciclos por amostra (flood_replay).
+ *
+ * Medição na placa: vReadJoystickValuesTask lê o contador do SysTick (clock do núcleo)
+ * antes e depois de cada chamada e informa o maior valor no relatório do heartbeat
+ * ("Previsao: max N ciclos"), que deve ficar abaixo deste orçamento; a chamada também
+ * aparece no trace como o trecho flood_forecast_update
+ */
+#ifndef FLOOD_FORECAST_CYCLE_BUDGET
+#define FLOOD_FORECAST_CYCLE_BUDGET 1000
+#endif
+
+#define FLOOD_FORECAST_NEVER UINT32_MAX //Limiar não será atingido na tendência atual
+
+//Limiares de nível do rio previstos, na ordem crescente
+typedef enum {
+    FLOOD_FORECAST_NORMAL = 0, //FLOOD_RIVER_NORMAL
+    FLOOD_FORECAST_HIGH, //FLOOD_RIVER_HIGH
+    FLOOD_FORECAST_DANGER, //FLOOD_RIVER_DANGER
+    FLOOD_FORECAST_THRESHOLDS
+} flood_forecast_threshold_t;
+
+//Estado da previsão
+typedef struct {
+    int32_t level; //Nível estimado do rio (um)
+    int32_t rate; //Taxa de subida estimada (Q8 um/amostra)
+    int32_t rain_rate; //Parcela da taxa atribuída à chuva (Q8 um/amostra)
+    uint32_t period_ms; //Intervalo entre amostras
+    uint32_t eta_s[FLOOD_FORECAST_THRESHOLDS]; //Tempo previsto até cada limiar (s)
+    flood_status_t status; //Status previsto já confirmado
+    flood_status_t candidate; //Status previsto aguardando confirmação
+    uint32_t persist; //Amostras seguidas em que o candidato se manteve
+    uint32_t outliers; //Amostras seguidas com erro de previsão acima do limite
+    bool primed; //Indica se o filtro já recebeu a primeira amostra
+} flood_forecast_t;
+
+void flood_forecast_init(flood_forecast_t *forecast, uint32_t period_ms);
+void flood_forecast_update(flood_forecast_t *forecast, int32_t level_mm, int32_t rain_x100);
+flood_status_t flood_forecast_status(const flood_forecast_t *forecast);
+
+#endif
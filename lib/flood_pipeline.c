@@ -0,0 +1,213 @@
+#include "flood_pipeline.h"
+
+/**
+ * @brief Converte as leituras brutas do ADC em nível do rio (m) e intensidade de chuva
+ *
+ * O eixo Y simula o sensor ultrassônico (nível do rio, de 0 a 10 metros) e
+ * o eixo X simula o sensor de chuva (0 a 100)
+ */
+void flood_normalize(uint32_t adc_x, uint32_t adc_y, float *river, float *rain)
+{
+    if (adc_y > FLOOD_ADC_DEADZONE_HIGH){
+        //Indica que o nível do rio subiu; calcula o valor atual (pode aumentar até 10.0 metros)
+        *river = FLOOD_RIVER_NORMAL + (FLOOD_RIVER_NORMAL * (adc_y - FLOOD_ADC_CENTER) / (FLOOD_ADC_CENTER - 1));
+    }else if (adc_y < FLOOD_ADC_DEADZONE_LOW){
+        //Indica que o nível do rio desceu; calcula o valor atual (pode diminuir até 0 metros)
+        *river = FLOOD_RIVER_NORMAL - (FLOOD_RIVER_NORMAL * (FLOOD_ADC_CENTER - adc_y) / (FLOOD_ADC_CENTER - 1));
+    }else {
+        *river = FLOOD_RIVER_NORMAL;
+    }
+
+    //Calcula a intensidade da chuva com base nos valores do eixo X
+    *rain = (FLOOD_RAIN_MAX * adc_x) / (float)FLOOD_ADC_MAX;
+}
+
+/**
+ * @brief Converte as leituras do ADC em nível do rio (mm) e chuva (centésimos) com aritmética inteira
+ *
+ * Usada pela previsão e pelos agregados, sem conversões de ponto flutuante (emuladas em
+ * software no RP2040). Ao contrário de flood_normalize, não aplica a zona morta do
+ * Joystick: o nível é contínuo em toda a faixa do ADC (um passo do ADC vale ~2,4 mm),
+ * pois os saltos da zona morta (606 mm em 1800 e 127 mm em 2100) seriam interpretados
+ * pela previsão como subidas reais do rio
+ */
+void flood_normalize_fixed(uint32_t adc_x, uint32_t adc_y, int32_t *river_mm, int32_t *rain_x100)
+{
+    const int32_t normal_mm = (int32_t)(FLOOD_RIVER_NORMAL * 1000);
+
+    *river_mm = normal_mm + normal_mm * ((int32_t)adc_y - FLOOD_ADC_CENTER) / (FLOOD_ADC_CENTER - 1);
+    if (*river_mm < 0) *river_mm = 0;
+
+    *rain_x100 = (int32_t)(FLOOD_RAIN_MAX * 100) * (int32_t)adc_x / FLOOD_ADC_MAX;
+}
+
+/**
+ * @brief Reinicia o estado do filtro
+ */
+void flood_filter_init(flood_filter_t *filter)
+{
+    filter->river = 0.0f;
+    filter->rain = 0.0f;
+    filter->primed = false;
+}
+
+/**
+ * @brief Aplica o filtro exponencial sobre os valores normalizados
+ *
+ * A primeira amostra é usada diretamente para não atrasar a resposta após o boot
+ */
+void flood_filter_apply(flood_filter_t *filter, float *river, float *rain)
+{
+    if (!filter->primed)
+    {
+        filter->river = *river;
+        filter->rain = *rain;
+        filter->primed = true;
+        return;
+    }
+
+    filter->river += FLOOD_FILTER_ALPHA * (*river - filter->river);
+    filter->rain += FLOOD_FILTER_ALPHA * (*rain - filter->rain);
+
+    *river = filter->river;
+    *rain = filter->rain;
+}
+
+/**
+ * @brief Reinicia o estado e os contadores da detecção de mudanças
+ */
+void flood_change_init(flood_change_detector_t *detector)
+{
+    detector->river = 0.0f;
+    detector->river_mm = 0;
+    detector->rain = 0.0f;
+    detector->status = FLOOD_SEGURO;
+    detector->alert_mode = false;
+    detector->lower_samples = 0;
+    detector->primed = false;
+    detector->since_forward = 0;
+    detector->forwarded = 0;
+    detector->suppressed = 0;
+}
+
+static float flood_absf(float value)
+{
+    return value < 0.0f ? -value : value;
+}
+
+//Status efetivo: classificação escalada pelo status previsto, como em vMapStatus
+static flood_status_t flood_effective_status(float river, float rain, flood_status_t forecast)
+{
+    flood_status_t status = flood_classify(river, rain);
+    return forecast > status ? forecast : status;
+}
+
+/**
+ * @brief Decide se a amostra deve ser repassada ao classificador
+ *
+ * São comparados o status e o modo de alerta efetivos (já escalados pela previsão): uma
+ * mudança no status previsto que não altera o resultado final não gera envio. Aumentos
+ * são repassados imediatamente. Uma redução só é aceita quando continua valendo com o
+ * nível e a chuva acrescidos da banda morta (o valor se afastou do limiar) ou depois de
+ * FLOOD_HYSTERESIS_SAMPLES amostras seguidas, evitando que o ruído sobre um limiar
+ * alterne o status e o alarme a cada amostra.
+ *
+ * A banda morta do nível usa river_mm (flood_normalize_fixed), que não tem a zona morta
+ * do Joystick: o salto de 127 mm em ADC 2100 seria maior que a banda morta e faria o
+ * ruído sobre a borda repassar metade das amostras.
+ *
+ * Após o retorno, detector->status e detector->alert_mode contêm o status e o modo de
+ * alerta que devem ser exibidos e acionados
+ */
+flood_change_t flood_change_update(flood_change_detector_t *detector, float river, float rain, int32_t river_mm,
+                                   flood_status_t forecast)
+{
+    int32_t river_delta = river_mm - detector->river_mm;
+    flood_status_t status = flood_effective_status(river, rain, forecast);
+    bool alert_mode = flood_alert_mode(river, rain) || forecast >= FLOOD_ALERTA;
+    flood_change_t reason;
+
+    if (detector->primed && (status < detector->status || (!alert_mode && detector->alert_mode)))
+    {
+        //Valores afastados do limiar pela banda morta
+        float river_margin = river + FLOOD_DEADBAND_RIVER, rain_margin = rain + FLOOD_DEADBAND_RAIN;
+        flood_status_t clear_status = flood_effective_status(river_margin, rain_margin, forecast);
+        bool clear_alert = flood_alert_mode(river_margin, rain_margin) || forecast >= FLOOD_ALERTA;
+        bool held = ++detector->lower_samples >= FLOOD_HYSTERESIS_SAMPLES;
+
+        //Mantém o valor anterior enquanto a redução não for confirmada
+        if (status < detector->status && !held)
+            status = clear_status < detector->status ? clear_status : detector->status;
+        if (!alert_mode && detector->alert_mode && !held && clear_alert)
+            alert_mode = true;
+    }else {
+        detector->lower_samples = 0;
+    }
+
+    if (!detector->primed)
+    {
+        reason = FLOOD_CHANGE_FIRST;
+    }else if (status != detector->status || alert_mode != detector->alert_mode){
+        reason = FLOOD_CHANGE_BAND;
+    }else if (river_delta > (int32_t)(FLOOD_DEADBAND_RIVER * 1000) || -river_delta > (int32_t)(FLOOD_DEADBAND_RIVER * 1000)
+              || flood_absf(rain - detector->rain) > FLOOD_DEADBAND_RAIN){
+        reason = FLOOD_CHANGE_DELTA;
+    }else if (detector->since_forward + 1 >= FLOOD_HEARTBEAT_SAMPLES){
+        reason = FLOOD_CHANGE_HEARTBEAT;
+    }else {
+        detector->since_forward++;
+        detector->suppressed++;
+        return FLOOD_CHANGE_NONE;
+    }
+
+    if (status != detector->status || alert_mode != detector->alert_mode) detector->lower_samples = 0;
+    detector->river = river;
+    detector->river_mm = river_mm;
+    detector->rain = rain;
+    detector->status = status;
+    detector->alert_mode = alert_mode;
+    detector->primed = true;
+    detector->since_forward = 0;
+    detector->forwarded++;
+
+    return reason;
+}
+
+/**
+ * @brief Calcula o nível de perigo com base no nível do rio e na intensidade da chuva
+ */
+flood_status_t flood_classify(float river, float rain)
+{
+    if (river >= FLOOD_RIVER_DANGER || (river >= FLOOD_RIVER_HIGH && rain > FLOOD_RAIN_HIGH))
+    {
+        return FLOOD_PERIGO;
+    }else if (river > FLOOD_RIVER_NORMAL && rain > FLOOD_RAIN_HIGH){
+        return FLOOD_ALERTA;
+    }else if ((river > FLOOD_RIVER_NORMAL && rain <= FLOOD_RAIN_HIGH) || (river <= FLOOD_RIVER_NORMAL && rain > FLOOD_RAIN_VERY_HIGH)){
+        return FLOOD_ATENCAO;
+    }
+
+    return FLOOD_SEGURO;
+}
+
+/**
+ * @brief Verifica se o Modo de Alerta deve ser ativado
+ */
+bool flood_alert_mode(float river, float rain)
+{
+    return river >= FLOOD_RIVER_HIGH || rain > FLOOD_RAIN_ALERT;
+}
+
+/**
+ * @brief Retorna o texto exibido no display para cada status
+ */
+const char *flood_status_name(flood_status_t status)
+{
+    switch (status)
+    {
+    case FLOOD_PERIGO: return "PERIGO";
+    case FLOOD_ALERTA: return "ALERTA";
+    case FLOOD_ATENCAO: return "ATENCAO";
+    default: return "SEGURO";
+    }
+}
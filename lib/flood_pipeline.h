@@ -0,0 +1,112 @@
+#ifndef FLOOD_PIPELINE_H
+#define FLOOD_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Pipeline de sensoriamento e classificação do monitor de enchentes.
+ *
+ * Não depende do SDK do Pico nem do FreeRTOS: recebe os valores brutos do ADC
+ * e devolve os valores normalizados e o status, podendo ser usado tanto nas
+ * tasks do firmware quanto em ferramentas no host.
+ */
+
+#define FLOOD_ADC_MAX 4095 //Valor máximo lido pelo ADC de 12 bits
+#define FLOOD_ADC_CENTER 2048 //Valor central do eixo do Joystick
+#define FLOOD_ADC_DEADZONE_HIGH 2100 //Acima deste valor o nível do rio sobe
+#define FLOOD_ADC_DEADZONE_LOW 1800 //Abaixo deste valor o nível do rio desce
+
+#define FLOOD_RIVER_NORMAL 5.0f //Nível normal do rio (m)
+#define FLOOD_RAIN_MAX 100.0f //Intensidade máxima de chuva
+
+/**
+ * Limiares usados na classificação
+ */
+#define FLOOD_RIVER_DANGER 9.0f //Nível do rio que indica PERIGO (m)
+#define FLOOD_RIVER_HIGH 7.0f //Nível do rio considerado alto (m)
+#define FLOOD_RAIN_HIGH 50.0f //Chuva considerada forte
+#define FLOOD_RAIN_VERY_HIGH 70.0f //Chuva que exige atenção mesmo com rio normal
+#define FLOOD_RAIN_ALERT 80.0f //Chuva que ativa o modo de alerta
+
+/**
+ * Fator do filtro exponencial aplicado aos valores normalizados (0.0 a 1.0).
+ * 1.0 desativa a filtragem e mantém a resposta imediata aos sensores.
+ */
+#ifndef FLOOD_FILTER_ALPHA
+#define FLOOD_FILTER_ALPHA 1.0f
+#endif
+
+/**
+ * Parâmetros da detecção de mudanças: a amostra só é repassada ao classificador
+ * quando varia mais que a banda morta, cruza algum limiar de classificação ou
+ * quando o intervalo máximo sem envio (heartbeat) é atingido.
+ * Aumentos de status são imediatos; reduções exigem que o valor se afaste do limiar
+ * pela banda morta ou que se mantenham por FLOOD_HYSTERESIS_SAMPLES amostras
+ */
+#ifndef FLOOD_DEADBAND_RIVER
+#define FLOOD_DEADBAND_RIVER 0.05f //Variação mínima do nível do rio (m), medida sem a zona morta
+#endif
+#ifndef FLOOD_DEADBAND_RAIN
+#define FLOOD_DEADBAND_RAIN 1.0f //Variação mínima da intensidade de chuva
+#endif
+#ifndef FLOOD_HYSTERESIS_SAMPLES
+#define FLOOD_HYSTERESIS_SAMPLES 20 //Amostras seguidas abaixo do limiar para aceitar uma redução de status
+#endif
+#ifndef FLOOD_HEARTBEAT_SAMPLES
+#define FLOOD_HEARTBEAT_SAMPLES 60 //Número máximo de amostras suprimidas em sequência
+#endif
+
+//Níveis de risco, em ordem crescente de gravidade
+typedef enum {
+    FLOOD_SEGURO = 0,
+    FLOOD_ATENCAO,
+    FLOOD_ALERTA,
+    FLOOD_PERIGO
+} flood_status_t;
+
+//Estado do filtro aplicado entre a normalização e a classificação
+typedef struct {
+    float river; //Último nível do rio filtrado
+    float rain; //Última intensidade de chuva filtrada
+    bool primed; //Indica se o filtro já recebeu a primeira amostra
+} flood_filter_t;
+
+//Motivo pelo qual uma amostra foi repassada (FLOOD_CHANGE_NONE indica que foi suprimida)
+typedef enum {
+    FLOOD_CHANGE_NONE = 0,
+    FLOOD_CHANGE_FIRST, //Primeira amostra após o boot
+    FLOOD_CHANGE_BAND, //Mudou o status ou o modo de alerta efetivos (incluindo a escalada pela previsão)
+    FLOOD_CHANGE_DELTA, //Variou mais que a banda morta
+    FLOOD_CHANGE_HEARTBEAT //Intervalo máximo sem envio atingido
+} flood_change_t;
+
+//Estado da detecção de mudanças
+typedef struct {
+    float river; //Nível do rio da última amostra repassada
+    int32_t river_mm; //Nível contínuo (sem zona morta) da última amostra repassada, usado na banda morta
+    float rain; //Intensidade de chuva da última amostra repassada
+    flood_status_t status; //Status efetivo (classificação escalada pela previsão) da última amostra repassada
+    bool alert_mode; //Modo de alerta efetivo da última amostra repassada
+    uint32_t lower_samples; //Amostras seguidas indicando redução de status ou do modo de alerta
+    bool primed; //Indica se alguma amostra já foi repassada
+    uint32_t since_forward; //Amostras suprimidas desde o último envio
+    uint32_t forwarded; //Total de amostras repassadas
+    uint32_t suppressed; //Total de amostras suprimidas
+} flood_change_detector_t;
+
+void flood_normalize(uint32_t adc_x, uint32_t adc_y, float *river, float *rain);
+void flood_normalize_fixed(uint32_t adc_x, uint32_t adc_y, int32_t *river_mm, int32_t *rain_x100);
+
+void flood_filter_init(flood_filter_t *filter);
+void flood_filter_apply(flood_filter_t *filter, float *river, float *rain);
+
+void flood_change_init(flood_change_detector_t *detector);
+flood_change_t flood_change_update(flood_change_detector_t *detector, float river, float rain, int32_t river_mm,
+                                   flood_status_t forecast);
+
+flood_status_t flood_classify(float river, float rain);
+bool flood_alert_mode(float river, float rain);
+const char *flood_status_name(flood_status_t status);
+
+#endif
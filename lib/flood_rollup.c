@@ -0,0 +1,175 @@
+#include "flood_rollup.h"
+
+#define FLOOD_ROLLUP_MINUTE_MS 60000U
+#define FLOOD_ROLLUP_HOUR_MS (60U * FLOOD_ROLLUP_MINUTE_MS)
+#define FLOOD_ROLLUP_DAY_MS (24U * FLOOD_ROLLUP_HOUR_MS)
+
+static void flood_rollup_bucket_clear(flood_rollup_bucket_t *bucket)
+{
+    bucket->min = INT32_MAX;
+    bucket->max = INT32_MIN;
+    bucket->count = 0;
+    bucket->level_sum = 0;
+    bucket->rain_ms = 0;
+}
+
+//Combina o bucket src no bucket dst
+static void flood_rollup_bucket_merge(flood_rollup_bucket_t *dst, const flood_rollup_bucket_t *src)
+{
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    dst->count += src->count;
+    dst->level_sum += src->level_sum;
+    dst->rain_ms += src->rain_ms;
+}
+
+static void flood_rollup_level_init(flood_rollup_level_t *level, flood_rollup_bucket_t *buckets,
+                                    uint32_t size, uint32_t span_ms, uint64_t now_ms)
+{
+    level->buckets = buckets;
+    level->size = size;
+    level->span_ms = span_ms;
+    level->head = 0;
+    level->next_boundary_ms = now_ms + span_ms;
+    flood_rollup_bucket_clear(&level->closed);
+
+    for (uint32_t i = 0; i < size; i++) flood_rollup_bucket_clear(&buckets[i]);
+}
+
+/**
+ * @brief Fecha o bucket corrente e abre um novo, descartando o mais antigo da janela
+ *
+ * Somas e contagens dos buckets fechados são atualizadas de forma incremental; o
+ * mínimo e o máximo são recalculados sobre os buckets fechados, o que ocorre no
+ * máximo uma vez por minuto (ou hora, ou dia) e não a cada amostra
+ */
+static void flood_rollup_level_advance(flood_rollup_level_t *level)
+{
+    flood_rollup_bucket_t *current = &level->buckets[level->head];
+    uint32_t oldest = (level->head + 1) % level->size;
+    flood_rollup_bucket_t *evicted = &level->buckets[oldest];
+
+    //O bucket corrente passa a ser fechado e o mais antigo sai da janela
+    level->closed.count += current->count - evicted->count;
+    level->closed.level_sum += current->level_sum - evicted->level_sum;
+    level->closed.rain_ms += current->rain_ms - evicted->rain_ms;
+
+    flood_rollup_bucket_clear(evicted);
+    level->head = oldest;
+
+    level->closed.min = INT32_MAX;
+    level->closed.max = INT32_MIN;
+    for (uint32_t i = 0; i < level->size; i++)
+    {
+        if (i == level->head) continue;
+        if (level->buckets[i].min < level->closed.min) level->closed.min = level->buckets[i].min;
+        if (level->buckets[i].max > level->closed.max) level->closed.max = level->buckets[i].max;
+    }
+}
+
+//Fecha os buckets cujo intervalo já terminou (inclusive os intervalos sem amostras)
+static void flood_rollup_level_seek(flood_rollup_level_t *level, uint64_t now_ms)
+{
+    uint32_t advanced = 0;
+
+    while (now_ms >= level->next_boundary_ms)
+    {
+        if (advanced == level->size)
+        {
+            //Intervalo sem amostras maior que a janela: todos os buckets já estão vazios.
+            //Pula os intervalos restantes mantendo o alinhamento com o instante inicial
+            level->next_boundary_ms += (now_ms - level->next_boundary_ms) / level->span_ms * level->span_ms
+                                     + level->span_ms;
+            break;
+        }
+        flood_rollup_level_advance(level);
+        level->next_boundary_ms += level->span_ms;
+        advanced++;
+    }
+}
+
+/**
+ * @brief Reinicia todos os agregados
+ *
+ * @param now_ms Instante atual, usado como início do primeiro bucket de cada resolução
+ */
+void flood_rollup_init(flood_rollup_t *rollup, uint64_t now_ms)
+{
+    flood_rollup_level_init(&rollup->levels[FLOOD_ROLLUP_MINUTE], rollup->minutes,
+                            FLOOD_ROLLUP_MINUTES, FLOOD_ROLLUP_MINUTE_MS, now_ms);
+    flood_rollup_level_init(&rollup->levels[FLOOD_ROLLUP_HOUR], rollup->hours,
+                            FLOOD_ROLLUP_HOURS, FLOOD_ROLLUP_HOUR_MS, now_ms);
+    flood_rollup_level_init(&rollup->levels[FLOOD_ROLLUP_DAY], rollup->days,
+                            FLOOD_ROLLUP_DAYS, FLOOD_ROLLUP_DAY_MS, now_ms);
+    rollup->last_ms = now_ms;
+    rollup->primed = false;
+}
+
+/**
+ * @brief Acumula uma amostra no bucket corrente de cada resolução
+ *
+ * A chuva é integrada no tempo decorrido desde a amostra anterior
+ *
+ * @param level_mm Nível do rio (mm)
+ * @param rain_x100 Intensidade da chuva em centésimos (0 a 10000)
+ */
+void flood_rollup_update(flood_rollup_t *rollup, uint64_t now_ms, int32_t level_mm, uint32_t rain_x100)
+{
+    uint64_t rain_ms = rollup->primed ? (uint64_t)rain_x100 * (now_ms - rollup->last_ms) : 0;
+    flood_rollup_bucket_t *current;
+
+    for (int i = 0; i < FLOOD_ROLLUP_TIERS; i++)
+    {
+        flood_rollup_level_seek(&rollup->levels[i], now_ms);
+
+        current = &rollup->levels[i].buckets[rollup->levels[i].head];
+        if (level_mm < current->min) current->min = level_mm;
+        if (level_mm > current->max) current->max = level_mm;
+        current->count++;
+        current->level_sum += level_mm;
+        current->rain_ms += rain_ms;
+    }
+
+    rollup->last_ms = now_ms;
+    rollup->primed = true;
+}
+
+static void flood_rollup_stats(const flood_rollup_bucket_t *bucket, flood_rollup_stats_t *stats)
+{
+    stats->count = bucket->count;
+    stats->rain_ms = bucket->rain_ms;
+    if (bucket->count > 0)
+    {
+        stats->min_mm = bucket->min;
+        stats->max_mm = bucket->max;
+        stats->mean_mm = (int32_t)(bucket->level_sum / bucket->count);
+    }else {
+        stats->min_mm = 0;
+        stats->max_mm = 0;
+        stats->mean_mm = 0;
+    }
+}
+
+/**
+ * @brief Consulta a janela completa de uma resolução (ex.: última hora em FLOOD_ROLLUP_MINUTE)
+ *
+ * A janela inclui o bucket corrente e os buckets fechados anteriores
+ */
+void flood_rollup_window(const flood_rollup_t *rollup, flood_rollup_tier_t tier, flood_rollup_stats_t *stats)
+{
+    const flood_rollup_level_t *level = &rollup->levels[tier];
+    flood_rollup_bucket_t window = level->closed;
+
+    flood_rollup_bucket_merge(&window, &level->buckets[level->head]);
+    flood_rollup_stats(&window, stats);
+}
+
+/**
+ * @brief Consulta apenas o bucket corrente de uma resolução (ex.: dia atual em FLOOD_ROLLUP_DAY)
+ */
+void flood_rollup_current(const flood_rollup_t *rollup, flood_rollup_tier_t tier, flood_rollup_stats_t *stats)
+{
+    const flood_rollup_level_t *level = &rollup->levels[tier];
+
+    flood_rollup_stats(&level->buckets[level->head], stats);
+}
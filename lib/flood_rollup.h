@@ -0,0 +1,78 @@
+#ifndef FLOOD_ROLLUP_H
+#define FLOOD_ROLLUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Agregados históricos do nível do rio e da chuva em várias resoluções.
+ *
+ * Cada amostra atualiza o bucket corrente de três níveis (minuto, hora e dia),
+ * guardados em buffers circulares de tamanho fixo. Para cada nível é mantido o
+ * agregado dos buckets fechados da janela, de modo que as consultas combinam
+ * apenas dois buckets (O(1)). A memória ocupada é definida em tempo de compilação.
+ *
+ * O tempo é contado desde o boot: "dia" significa 24 h de funcionamento.
+ */
+
+#ifndef FLOOD_ROLLUP_MINUTES
+#define FLOOD_ROLLUP_MINUTES 60 //Buckets de 1 minuto (janela de 1 hora)
+#endif
+#ifndef FLOOD_ROLLUP_HOURS
+#define FLOOD_ROLLUP_HOURS 24 //Buckets de 1 hora (janela de 1 dia)
+#endif
+#ifndef FLOOD_ROLLUP_DAYS
+#define FLOOD_ROLLUP_DAYS 7 //Buckets de 1 dia (janela de 1 semana)
+#endif
+
+//Resoluções disponíveis
+typedef enum {
+    FLOOD_ROLLUP_MINUTE = 0,
+    FLOOD_ROLLUP_HOUR,
+    FLOOD_ROLLUP_DAY,
+    FLOOD_ROLLUP_TIERS
+} flood_rollup_tier_t;
+
+//Agregado de um intervalo de tempo
+typedef struct {
+    int32_t min; //Menor nível do rio (mm)
+    int32_t max; //Maior nível do rio (mm)
+    uint32_t count; //Número de amostras
+    int64_t level_sum; //Soma dos níveis (mm), usada para a média
+    uint64_t rain_ms; //Integral da chuva (centésimos de intensidade x ms)
+} flood_rollup_bucket_t;
+
+//Estado de uma resolução
+typedef struct {
+    flood_rollup_bucket_t *buckets; //Buffer circular; buckets[head] é o bucket corrente
+    uint32_t size; //Número de buckets da janela (incluindo o corrente)
+    uint32_t span_ms; //Duração de cada bucket
+    uint32_t head; //Posição do bucket corrente
+    uint64_t next_boundary_ms; //Instante em que o bucket corrente é fechado
+    flood_rollup_bucket_t closed; //Agregado dos buckets fechados da janela
+} flood_rollup_level_t;
+
+typedef struct {
+    flood_rollup_bucket_t minutes[FLOOD_ROLLUP_MINUTES];
+    flood_rollup_bucket_t hours[FLOOD_ROLLUP_HOURS];
+    flood_rollup_bucket_t days[FLOOD_ROLLUP_DAYS];
+    flood_rollup_level_t levels[FLOOD_ROLLUP_TIERS];
+    uint64_t last_ms; //Instante da última amostra
+    bool primed; //Indica se alguma amostra já foi recebida
+} flood_rollup_t;
+
+//Resultado de uma consulta
+typedef struct {
+    int32_t min_mm; //Menor nível do rio (mm)
+    int32_t max_mm; //Maior nível do rio (mm)
+    int32_t mean_mm; //Nível médio do rio (mm)
+    uint32_t count; //Número de amostras (0 indica janela sem dados)
+    uint64_t rain_ms; //Chuva acumulada (centésimos de intensidade x ms)
+} flood_rollup_stats_t;
+
+void flood_rollup_init(flood_rollup_t *rollup, uint64_t now_ms);
+void flood_rollup_update(flood_rollup_t *rollup, uint64_t now_ms, int32_t level_mm, uint32_t rain_x100);
+void flood_rollup_window(const flood_rollup_t *rollup, flood_rollup_tier_t tier, flood_rollup_stats_t *stats);
+void flood_rollup_current(const flood_rollup_t *rollup, flood_rollup_tier_t tier, flood_rollup_stats_t *stats);
+
+#endif
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "rtos_trace.h"
+
+#if (TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) != 0
+#error "TRACE_BUFFER_SIZE deve ser uma potência de 2"
+#endif
+
+//Evento armazenado no buffer circular
+typedef struct {
+    uint32_t timestamp; //Tempo em microssegundos desde o boot
+    uint32_t event; //Tipo do evento (trace_event_t)
+    uint32_t arg; //Handle da task/fila ou identificador do trecho
+} trace_entry_t;
+
+//Objeto (task ou fila) associado a um nome legível
+typedef struct {
+    const void *object;
+    const char *name;
+} trace_name_t;
+
+static trace_entry_t trace_buffer[TRACE_BUFFER_SIZE];
+static volatile uint32_t trace_head; //Total de eventos já escritos
+static uint32_t trace_tail; //Total de eventos já enviados pela serial
+static uint32_t trace_lost; //Eventos sobrescritos antes de serem enviados
+
+static trace_name_t trace_names[TRACE_MAX_NAMES];
+static uint32_t trace_name_count;
+
+/**
+ * @brief Registra um evento no buffer circular
+ *
+ * Pode ser chamada de tasks, interrupções e de dentro do kernel. No RP2040 (single
+ * core para o FreeRTOS) basta mascarar as interrupções durante a escrita da entrada,
+ * o que custa poucos ciclos e dispensa mutexes
+ */
+void __not_in_flash_func(trace_record)(uint32_t event, uint32_t arg)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    trace_entry_t *entry = &trace_buffer[trace_head & (TRACE_BUFFER_SIZE - 1)];
+    entry->timestamp = timer_hw->timerawl;
+    entry->event = event;
+    entry->arg = arg;
+    trace_head++;
+    restore_interrupts(irq);
+}
+
+/**
+ * @brief Associa um nome a uma task ou fila para exibição na linha do tempo
+ */
+void trace_name(const void *object, const char *name)
+{
+    if (trace_name_count < TRACE_MAX_NAMES)
+    {
+        trace_names[trace_name_count].object = object;
+        trace_names[trace_name_count].name = name;
+        trace_name_count++;
+    }
+}
+
+/**
+ * @brief Envia pela serial os eventos registrados desde o último envio
+ *
+ * Formato de texto, uma linha por registro:
+ *   "N <handle> <nome>"           nome de uma task ou fila
+ *   "E <tempo_us> <tipo> <arg>"   evento (valores em hexadecimal)
+ *   "L <quantidade>"              eventos perdidos por sobrescrita
+ */
+void trace_dump(void)
+{
+    trace_entry_t entry;
+    uint32_t irq, head;
+
+    printf("#TRACE BEGIN\n");
+    for (uint32_t i = 0; i < trace_name_count; i++)
+    {
+        printf("N %08lx %s\n", (unsigned long)(uintptr_t)trace_names[i].object, trace_names[i].name);
+    }
+
+    head = trace_head;
+    if (head - trace_tail > TRACE_BUFFER_SIZE)
+    {
+        trace_lost += head - trace_tail - TRACE_BUFFER_SIZE;
+        trace_tail = head - TRACE_BUFFER_SIZE;
+    }
+
+    while (trace_tail != head)
+    {
+        //Copia a entrada e confirma que ela não foi sobrescrita durante o envio
+        irq = save_and_disable_interrupts();
+        if (trace_head - trace_tail > TRACE_BUFFER_SIZE)
+        {
+            restore_interrupts(irq);
+            trace_lost++;
+            trace_tail++;
+            continue;
+        }
+        entry = trace_buffer[trace_tail & (TRACE_BUFFER_SIZE - 1)];
+        restore_interrupts(irq);
+
+        printf("E %08lx %lx %08lx\n", (unsigned long)entry.timestamp,
+               (unsigned long)entry.event, (unsigned long)entry.arg);
+        trace_tail++;
+    }
+
+    printf("L %lu\n#TRACE END\n", (unsigned long)trace_lost);
+}
@@ -0,0 +1,79 @@
+#ifndef RTOS_TRACE_H
+#define RTOS_TRACE_H
+
+#include <stdint.h>
+
+/**
+ * Rastreamento de eventos do kernel e da aplicação em um buffer circular na RAM.
+ *
+ * Cada evento guarda o tempo em microssegundos, o tipo e um argumento de 32 bits
+ * (handle da task ou da fila, ou identificador do trecho da aplicação). A gravação
+ * fica sempre ativa, sobrescrevendo os eventos mais antigos; o buffer só é enviado
+ * pela serial (USB/UART) quando trace_dump é chamado, e convertido no host para uma
+ * linha do tempo do Perfetto/Chrome com tools/trace_to_perfetto.py
+ */
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1 //0 remove todos os pontos de rastreamento do firmware
+#endif
+
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 512 //Número de eventos do buffer circular (potência de 2)
+#endif
+
+#ifndef TRACE_MAX_NAMES
+#define TRACE_MAX_NAMES 16 //Número máximo de tasks e filas nomeadas
+#endif
+
+//Tipos de evento registrados no buffer
+typedef enum {
+    TRACE_EV_TASK_SWITCH_IN = 1,
+    TRACE_EV_QUEUE_SEND,
+    TRACE_EV_QUEUE_RECEIVE,
+    TRACE_EV_QUEUE_BLOCK_SEND,
+    TRACE_EV_QUEUE_BLOCK_RECEIVE,
+    TRACE_EV_NOTIFY,
+    TRACE_EV_NOTIFY_BLOCK,
+    TRACE_EV_SPAN_BEGIN,
+    TRACE_EV_SPAN_END
+} trace_event_t;
+
+//Trechos da aplicação medidos com TRACE_SPAN_BEGIN/TRACE_SPAN_END
+typedef enum {
+    TRACE_SPAN_ADC_READ = 0,
+    TRACE_SPAN_DISPLAY_SEND,
+    TRACE_SPAN_MATRIX_WRITE,
+    TRACE_SPAN_FORECAST
+} trace_span_t;
+
+void trace_record(uint32_t event, uint32_t arg);
+void trace_name(const void *object, const char *name);
+void trace_dump(void);
+
+#if TRACE_ENABLED
+
+#define TRACE_SPAN_BEGIN(span) trace_record(TRACE_EV_SPAN_BEGIN, (span))
+#define TRACE_SPAN_END(span) trace_record(TRACE_EV_SPAN_END, (span))
+
+/**
+ * Macros de rastreamento do FreeRTOS (incluídas pelo FreeRTOSConfig.h)
+ */
+#define traceTASK_SWITCHED_IN() trace_record(TRACE_EV_TASK_SWITCH_IN, (uint32_t)pxCurrentTCB)
+#define traceQUEUE_SEND(pxQueue) trace_record(TRACE_EV_QUEUE_SEND, (uint32_t)(pxQueue))
+#define traceQUEUE_RECEIVE(pxQueue) trace_record(TRACE_EV_QUEUE_RECEIVE, (uint32_t)(pxQueue))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) trace_record(TRACE_EV_QUEUE_BLOCK_SEND, (uint32_t)(pxQueue))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) trace_record(TRACE_EV_QUEUE_BLOCK_RECEIVE, (uint32_t)(pxQueue))
+#define traceTASK_NOTIFY(...) trace_record(TRACE_EV_NOTIFY, (uint32_t)xTaskToNotify)
+#define traceTASK_NOTIFY_FROM_ISR(...) trace_record(TRACE_EV_NOTIFY, (uint32_t)xTaskToNotify)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR(...) trace_record(TRACE_EV_NOTIFY, (uint32_t)xTaskToNotify)
+#define traceTASK_NOTIFY_TAKE_BLOCK(...) trace_record(TRACE_EV_NOTIFY_BLOCK, (uint32_t)pxCurrentTCB)
+#define traceTASK_NOTIFY_WAIT_BLOCK(...) trace_record(TRACE_EV_NOTIFY_BLOCK, (uint32_t)pxCurrentTCB)
+
+#else
+
+#define TRACE_SPAN_BEGIN(span)
+#define TRACE_SPAN_END(span)
+
+#endif
+
+#endif
@@ -1,6 +1,13 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
-#include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// O framebuffer (ssd1306_gfx.c) não depende do SDK; apenas o transporte (ssd1306.c) usa o I2C
+struct i2c_inst;
 
 #define WIDTH 128
 #define HEIGHT 64
@@ -27,18 +34,22 @@ typedef enum {
 
 typedef struct {
   uint8_t width, height, pages, address;
-  i2c_inst_t *i2c_port;
+  struct i2c_inst *i2c_port;
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
 } ssd1306_t;
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+// Framebuffer (ssd1306_gfx.c)
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, struct i2c_inst *i2c);
+
+// Transporte I2C (ssd1306.c)
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
 
+// Desenho no framebuffer (ssd1306_gfx.c); coordenadas fora do display são recortadas
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
@@ -46,4 +57,6 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#endif
@@ -0,0 +1,187 @@
+#include <string.h>
+#include "ssd1306.h"
+#include "font.h"
+
+// Não acessa o barramento I2C: apenas aloca e prepara o framebuffer
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, struct i2c_inst *i2c) {
+  ssd->width = width;
+  ssd->height = height;
+  ssd->pages = height / 8U;
+  ssd->external_vcc = external_vcc;
+  ssd->address = address;
+  ssd->i2c_port = i2c;
+  ssd->bufsize = ssd->pages * ssd->width + 1;
+  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->ram_buffer[0] = 0x40;
+  ssd->port_buffer[0] = 0x80;
+}
+
+// Retorna true se a coordenada está dentro do display
+static inline bool ssd1306_in_bounds(ssd1306_t *ssd, int x, int y) {
+  return x >= 0 && y >= 0 && x < ssd->width && y < ssd->height;
+}
+
+// Desenha um pixel com coordenadas int: os helpers calculam posições que podem passar
+// de 255, e a conversão para uint8_t antes do recorte as faria voltar para o início do display
+static inline void ssd1306_pixel_clip(ssd1306_t *ssd, int x, int y, bool value) {
+  // Pixels fora do display são descartados (recorte)
+  if (!ssd1306_in_bounds(ssd, x, y))
+    return;
+
+  // Endereçamento vertical: cada coluna ocupa "pages" bytes consecutivos
+  uint16_t index = (y >> 3) + x * ssd->pages + 1;
+  uint8_t pixel = (y & 0b111);
+  if (value)
+    ssd->ram_buffer[index] |= (1 << pixel);
+  else
+    ssd->ram_buffer[index] &= ~(1 << pixel);
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  ssd1306_pixel_clip(ssd, x, y, value);
+}
+
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  // Preenche o framebuffer inteiro de uma vez (o byte 0 é o byte de controle I2C)
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  int right = left + width - 1;
+  int bottom = top + height - 1;
+
+  if (width == 0 || height == 0)
+    return;
+
+  for (int x = left; x <= right && x < ssd->width; ++x) {
+    ssd1306_pixel_clip(ssd, x, top, value);
+    ssd1306_pixel_clip(ssd, x, bottom, value);
+  }
+  for (int y = top; y <= bottom && y < ssd->height; ++y) {
+    ssd1306_pixel_clip(ssd, left, y, value);
+    ssd1306_pixel_clip(ssd, right, y, value);
+  }
+
+  if (fill) {
+    for (int x = left + 1; x < right && x < ssd->width; ++x) {
+      for (int y = top + 1; y < bottom && y < ssd->height; ++y) {
+        ssd1306_pixel_clip(ssd, x, y, value);
+      }
+    }
+  }
+}
+
+void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+
+    int err = dx - dy;
+
+    while (true) {
+        ssd1306_pixel(ssd, x0, y0, value); // Desenha o pixel atual (recortado se estiver fora)
+
+        if (x0 == x1 && y0 == y1) break; // Termina quando alcança o ponto final
+
+        int e2 = err * 2;
+
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+
+void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+  for (int x = x0; x <= x1 && x < ssd->width; ++x)
+    ssd1306_pixel_clip(ssd, x, y, value);
+}
+
+void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  for (int y = y0; y <= y1 && y < ssd->height; ++y)
+    ssd1306_pixel_clip(ssd, x, y, value);
+}
+
+// Função para desenhar um caractere
+void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  uint16_t index = 0;
+
+  // Verifica o caractere e calcula o índice correspondente na fonte
+  if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
+  {
+    index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
+  }
+  else
+  {
+    // Caractere inválido, desenha um espaço (ou pode ser tratado de outra forma)
+    index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
+  }
+
+  // Caso comum: caractere inteiro visível. Cada coluna da fonte tem o mesmo formato de um
+  // byte do framebuffer: com y múltiplo de 8 é copiada direto; senão é deslocada e dividida
+  // entre duas páginas, preservando os pixels das linhas vizinhas (o display usa y = 5, 18, 34, 49)
+  if (x + 8 <= ssd->width && y + 8 <= ssd->height)
+  {
+    uint8_t *column = &ssd->ram_buffer[(y >> 3) + x * ssd->pages + 1];
+    uint8_t shift = y & 0b111;
+    if (shift == 0)
+    {
+      for (uint8_t i = 0; i < 8; ++i)
+      {
+        *column = font[index + i];
+        column += ssd->pages;
+      }
+    }
+    else
+    {
+      uint8_t keep = (1 << shift) - 1; // Linhas da página de cima acima do caractere
+      for (uint8_t i = 0; i < 8; ++i)
+      {
+        uint8_t line = font[index + i];
+        column[0] = (column[0] & keep) | (line << shift);
+        column[1] = (column[1] & ~keep) | (line >> (8 - shift));
+        column += ssd->pages;
+      }
+    }
+    return;
+  }
+
+  // Desenha o caractere na tela pixel a pixel (parcialmente fora do display)
+  for (uint8_t i = 0; i < 8; ++i)
+  {
+    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
+    for (uint8_t j = 0; j < 8; ++j)
+    {
+      ssd1306_pixel_clip(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+    }
+  }
+}
+
+// Função para desenhar uma string
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+  while (*str)
+  {
+    // Quebra a linha apenas se o próximo caractere não couber inteiro
+    if (x + 8 > ssd->width)
+    {
+      x = 0;
+      y += 8;
+    }
+    if (y + 8 > ssd->height)
+    {
+      break;
+    }
+    ssd1306_draw_char(ssd, *str++, x, y);
+    x += 8;
+  }
+}
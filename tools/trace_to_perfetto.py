@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+Converte o rastreamento enviado pela serial (lib/rtos_trace.c) para o formato
+JSON de trace do Chrome, que pode ser aberto em https://ui.perfetto.dev ou
+chrome://tracing.
+
+Uso:
+    python3 tools/trace_to_perfetto.py captura_serial.txt > trace.json
+
+Linhas que não pertencem a um bloco #TRACE são ignoradas, então o log completo
+da serial pode ser usado diretamente. Cada bloco é convertido separadamente: o
+intervalo entre dois envios não é conhecido, então os tempos de cada bloco partem
+do contador de microssegundos da placa.
+"""
+import json
+import sys
+
+TASK_SWITCH_IN = 1
+QUEUE_SEND = 2
+QUEUE_RECEIVE = 3
+QUEUE_BLOCK_SEND = 4
+QUEUE_BLOCK_RECEIVE = 5
+NOTIFY = 6
+NOTIFY_BLOCK = 7
+SPAN_BEGIN = 8
+SPAN_END = 9
+
+INSTANT_NAMES = {
+    QUEUE_SEND: "queue send",
+    QUEUE_RECEIVE: "queue receive",
+    QUEUE_BLOCK_SEND: "queue block send",
+    QUEUE_BLOCK_RECEIVE: "queue block receive",
+    NOTIFY: "notify",
+    NOTIFY_BLOCK: "notify block",
+}
+
+SPAN_NAMES = ["adc_read", "ssd1306_send_data", "pio matrix write", "flood_forecast_update"]
+
+PID = 1
+
+
+def parse(lines):
+    """Retorna (nomes, blocos) a partir das linhas da serial.
+
+    Cada bloco #TRACE é um dicionário com os eventos ("events") e o total de eventos
+    perdidos informado pela linha L ("lost", acumulado desde o boot).
+    """
+    names = {}
+    blocks = []
+    block = None
+    for raw in lines:
+        line = raw.strip()
+        if line == "#TRACE BEGIN":
+            block = {"events": [], "lost": None}
+            blocks.append(block)
+            continue
+        if line == "#TRACE END":
+            block = None
+            continue
+        if block is None or not line:
+            continue
+        fields = line.split(" ", 3)
+        if fields[0] == "N" and len(fields) >= 3:
+            names[int(fields[1], 16)] = " ".join(fields[2:])
+        elif fields[0] == "E" and len(fields) == 4:
+            block["events"].append((int(fields[1], 16), int(fields[2], 16), int(fields[3], 16)))
+        elif fields[0] == "L" and len(fields) == 2:
+            block["lost"] = int(fields[1])
+    return names, blocks
+
+
+def lost_per_block(blocks):
+    """Eventos sobrescritos antes do envio de cada bloco (a linha L é acumulada)."""
+    result = []
+    previous = 0
+    for block in blocks:
+        total = block["lost"] if block["lost"] is not None else previous
+        result.append(max(total - previous, 0))
+        previous = max(total, previous)
+    return result
+
+
+def unwrap(events):
+    """Corrige o estouro do contador de 32 bits em microssegundos (~71 min).
+
+    Deve ser chamada para cada bloco: entre dois envios pode passar qualquer tempo
+    (inclusive vários estouros), então o estado não é levado de um bloco para o outro.
+    """
+    offset = 0
+    last = None
+    result = []
+    for timestamp, event, arg in events:
+        if last is not None and timestamp < last:
+            offset += 1 << 32
+        last = timestamp
+        result.append((timestamp + offset, event, arg))
+    return result
+
+
+def convert_block(events, label, trace):
+    """Converte os eventos de um bloco, fechando no último instante o que ficou aberto."""
+    running = None
+    running_since = 0
+    open_spans = {}
+    timestamp = 0
+    for timestamp, event, arg in unwrap(events):
+        tid = running if running is not None else 0
+        if event == TASK_SWITCH_IN:
+            if running is not None and running != arg:
+                trace.append({"name": label(running), "ph": "X", "pid": PID, "tid": running,
+                              "ts": running_since, "dur": timestamp - running_since})
+            if running != arg:
+                running = arg
+                running_since = timestamp
+        elif event in INSTANT_NAMES:
+            trace.append({"name": INSTANT_NAMES[event], "ph": "i", "s": "t", "pid": PID, "tid": tid,
+                          "ts": timestamp, "args": {"object": label(arg)}})
+        elif event in (SPAN_BEGIN, SPAN_END):
+            name = SPAN_NAMES[arg] if arg < len(SPAN_NAMES) else "span %d" % arg
+            stack = open_spans.setdefault(tid, [])
+            if event == SPAN_BEGIN:
+                stack.append(name)
+            elif name in stack:
+                stack.remove(name)
+            else:
+                # Início sobrescrito no buffer circular: o fim isolado é descartado
+                continue
+            trace.append({"name": name, "ph": "B" if event == SPAN_BEGIN else "E",
+                          "pid": PID, "tid": tid, "ts": timestamp})
+
+    # A task em execução e os trechos abertos terminam no último evento enviado
+    if running is not None:
+        trace.append({"name": label(running), "ph": "X", "pid": PID, "tid": running,
+                      "ts": running_since, "dur": timestamp - running_since})
+    for tid, stack in open_spans.items():
+        for name in reversed(stack):
+            trace.append({"name": name, "ph": "E", "pid": PID, "tid": tid, "ts": timestamp})
+
+
+def convert(names, blocks):
+    def label(handle):
+        return names.get(handle, "0x%08x" % handle)
+
+    trace = []
+    for block in blocks:
+        convert_block(block["events"], label, trace)
+
+    tids = {0} | {e["tid"] for e in trace}
+    for tid in tids:
+        trace.append({"name": "thread_name", "ph": "M", "pid": PID, "tid": tid,
+                      "args": {"name": label(tid) if tid else "boot"}})
+    return trace
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        return 1
+
+    with open(sys.argv[1], encoding="utf-8", errors="replace") as capture:
+        names, blocks = parse(capture)
+
+    lost = lost_per_block(blocks)
+    for index, count in enumerate(lost):
+        if count:
+            sys.stderr.write("aviso: bloco %d: %d eventos perdidos por sobrescrita do buffer\n" % (index + 1, count))
+
+    json.dump({"traceEvents": convert(names, blocks), "displayTimeUnit": "ms",
+               "otherData": {"blocks": len(blocks), "lost_events": sum(lost)}}, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())